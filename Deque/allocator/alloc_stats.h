@@ -0,0 +1,281 @@
+/**
+ * @file
+ * @brief Allocation statistics header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains allocation statistics and latency timer classes, enabled with DEQUE_ALLOC_STATS macro
+ */
+
+#pragma once
+
+#ifndef __ALLOC_STATS_H_INCLUDED
+#define __ALLOC_STATS_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef DEQUE_ALLOC_STATS
+
+/**
+ * @brief Allocation statistics class.
+ *
+ * Counters of allocations made through allocators with one strategy.
+ * Counters are updated with relaxed atomics, so statistics of concurrently used strategy are consistent only eventually.
+ * Latency histogram bucket i counts strategy calls which took from 2^i to 2^(i+1) nanoseconds.
+ */
+class alloc_stats_t {
+public:
+  static constexpr bool isEnabled = true;  ///< statistics are collected flag
+  static constexpr size_t numOfBuckets = 32;  ///< number of latency histogram buckets
+
+private:
+  std::atomic<uint64_t>
+    liveBlocks{0},                 ///< number of allocated not freed blocks
+    liveBytes{0},                  ///< size of allocated not freed blocks
+    peakBytes{0},                  ///< maximal size of allocated not freed blocks
+    allocs{0},                     ///< number of allocated blocks
+    deallocs{0},                   ///< number of freed blocks
+    latency[numOfBuckets] = {};    ///< allocation latency histogram
+
+public:
+  /**
+   * Register blocks allocation function.
+   * @param[in] numOfBytes size of one block
+   * @param[in] count number of blocks
+   * @param[in] nanoseconds strategy call duration
+   */
+  void OnAlloc(size_t numOfBytes, size_t count, uint64_t nanoseconds) {
+    allocs.fetch_add(count, std::memory_order_relaxed);
+    liveBlocks.fetch_add(count, std::memory_order_relaxed);
+    uint64_t
+      bytes = liveBytes.fetch_add(numOfBytes * count, std::memory_order_relaxed) + numOfBytes * count,
+      peak = peakBytes.load(std::memory_order_relaxed);
+    while (bytes > peak && !peakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed))
+      ;
+    size_t bucket = 0;
+    while (bucket + 1 < numOfBuckets && (nanoseconds >> (bucket + 1)) != 0)
+      bucket++;
+    latency[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Register blocks deallocation function.
+   * @param[in] numOfBytes size of one block
+   * @param[in] count number of blocks
+   */
+  void OnDealloc(size_t numOfBytes, size_t count) {
+    deallocs.fetch_add(count, std::memory_order_relaxed);
+    liveBlocks.fetch_sub(count, std::memory_order_relaxed);
+    liveBytes.fetch_sub(numOfBytes * count, std::memory_order_relaxed);
+  }
+
+  /**
+   * Register release of all blocks at once function.
+   */
+  void OnRelease(void) {
+    deallocs.fetch_add(liveBlocks.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+    liveBytes.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * Register blocks of another strategy taken by absorption function.
+   * @param[in] source statistics of absorbed strategy
+   */
+  void OnAbsorb(alloc_stats_t &source) {
+    uint64_t
+      blocks = source.liveBlocks.exchange(0, std::memory_order_relaxed),
+      bytes = source.liveBytes.exchange(0, std::memory_order_relaxed);
+    liveBlocks.fetch_add(blocks, std::memory_order_relaxed);
+    bytes += liveBytes.fetch_add(bytes, std::memory_order_relaxed);
+    uint64_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (bytes > peak && !peakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed))
+      ;
+  }
+
+  /**
+   * Get number of allocated not freed blocks function.
+   * @return number of blocks
+   */
+  uint64_t LiveBlocks(void) const {
+    return liveBlocks.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Get size of allocated not freed blocks function.
+   * @return number of bytes
+   */
+  uint64_t LiveBytes(void) const {
+    return liveBytes.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Get maximal size of allocated not freed blocks function.
+   * @return number of bytes
+   */
+  uint64_t PeakBytes(void) const {
+    return peakBytes.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Get number of allocated blocks function.
+   * @return number of blocks
+   */
+  uint64_t Allocs(void) const {
+    return allocs.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Get number of freed blocks function.
+   * @return number of blocks
+   */
+  uint64_t Deallocs(void) const {
+    return deallocs.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Get latency histogram bucket function.
+   * @param[in] bucket bucket index
+   * @return number of strategy calls which took from 2^bucket to 2^(bucket+1) nanoseconds
+   */
+  uint64_t Latency(size_t bucket) const {
+    return latency[bucket].load(std::memory_order_relaxed);
+  }
+};
+
+/**
+ * @brief Allocation latency timer class.
+ *
+ * Measures time from construction.
+ */
+class alloc_timer_t {
+private:
+  std::chrono::steady_clock::time_point start;  ///< construction time
+
+public:
+  /**
+   * Constructor. Starts timer.
+   */
+  alloc_timer_t(void) : start(std::chrono::steady_clock::now()) {
+  }
+
+  /**
+   * Get elapsed time function.
+   * @return number of nanoseconds from construction
+   */
+  uint64_t Elapsed(void) const {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - start).count());
+  }
+};
+
+#else
+
+/**
+ * @brief Disabled allocation statistics class.
+ *
+ * Statistics are not collected, all counters are zero.
+ */
+class alloc_stats_t {
+public:
+  static constexpr bool isEnabled = false;    ///< statistics are collected flag
+  static constexpr size_t numOfBuckets = 32;  ///< number of latency histogram buckets
+
+  /**
+   * Register blocks allocation function. Does nothing.
+   * @param[in] numOfBytes size of one block
+   * @param[in] count number of blocks
+   * @param[in] nanoseconds strategy call duration
+   */
+  void OnAlloc(size_t numOfBytes, size_t count, uint64_t nanoseconds) {
+  }
+
+  /**
+   * Register blocks deallocation function. Does nothing.
+   * @param[in] numOfBytes size of one block
+   * @param[in] count number of blocks
+   */
+  void OnDealloc(size_t numOfBytes, size_t count) {
+  }
+
+  /**
+   * Register release of all blocks at once function. Does nothing.
+   */
+  void OnRelease(void) {
+  }
+
+  /**
+   * Register blocks of another strategy taken by absorption function. Does nothing.
+   * @param[in] source statistics of absorbed strategy
+   */
+  void OnAbsorb(alloc_stats_t &source) {
+  }
+
+  /**
+   * Get number of allocated not freed blocks function.
+   * @return 0
+   */
+  uint64_t LiveBlocks(void) const {
+    return 0;
+  }
+
+  /**
+   * Get size of allocated not freed blocks function.
+   * @return 0
+   */
+  uint64_t LiveBytes(void) const {
+    return 0;
+  }
+
+  /**
+   * Get maximal size of allocated not freed blocks function.
+   * @return 0
+   */
+  uint64_t PeakBytes(void) const {
+    return 0;
+  }
+
+  /**
+   * Get number of allocated blocks function.
+   * @return 0
+   */
+  uint64_t Allocs(void) const {
+    return 0;
+  }
+
+  /**
+   * Get number of freed blocks function.
+   * @return 0
+   */
+  uint64_t Deallocs(void) const {
+    return 0;
+  }
+
+  /**
+   * Get latency histogram bucket function.
+   * @param[in] bucket bucket index
+   * @return 0
+   */
+  uint64_t Latency(size_t bucket) const {
+    return 0;
+  }
+};
+
+/**
+ * @brief Disabled allocation latency timer class.
+ */
+class alloc_timer_t {
+public:
+  /**
+   * Get elapsed time function.
+   * @return 0
+   */
+  uint64_t Elapsed(void) const {
+    return 0;
+  }
+};
+
+#endif /* DEQUE_ALLOC_STATS */
+
+#endif /* __ALLOC_STATS_H_INCLUDED */
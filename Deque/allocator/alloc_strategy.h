@@ -11,6 +11,11 @@
 #ifndef __ALLOC_STRATEGY_H_INCLUDED
 #define __ALLOC_STRATEGY_H_INCLUDED
 
+#include <cstddef>
+#include <cstdint>
+
+#include "alloc_stats.h"
+
 /**
  * @brief Allocation strategy base virtual class.
  *
@@ -18,6 +23,30 @@
  */
 class alloc_strategy_t {
 public:
+  static constexpr size_t defaultAlignment = alignof(std::max_align_t);  ///< alignment of blocks given by alloc
+  static constexpr bool isThreadSafe = false;                            ///< strategy can be called concurrently flag
+
+#ifdef DEQUE_ALLOC_STATS
+private:
+  alloc_stats_t statistics;  ///< statistics of allocations through allocators
+
+public:
+#endif /* DEQUE_ALLOC_STATS */
+  /**
+   * Get allocation statistics function.
+   * Statistics are collected by allocators only if DEQUE_ALLOC_STATS macro is defined,
+   * otherwise all strategies share one disabled statistics instance.
+   * @return reference to statistics
+   */
+  alloc_stats_t &stats(void) {
+#ifdef DEQUE_ALLOC_STATS
+    return statistics;
+#else
+    static alloc_stats_t disabled;
+    return disabled;
+#endif /* DEQUE_ALLOC_STATS */
+  }
+
   /**
    * Allocation with memory block size function.
    * @param[in] numOfBytes number of bytes to push
@@ -31,11 +60,166 @@ public:
    */
   virtual void dealloc(void *ptr) = 0;
 
+  /**
+   * Dealocation with pointer and block size function.
+   * Default implementation ignores size.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   */
+  virtual void dealloc_sized(void *ptr, size_t numOfBytes) {
+    dealloc(ptr);
+  }
+
+  /**
+   * Allocation of several memory blocks of one size function.
+   * Default implementation allocates blocks one by one.
+   * @param[in] numOfBytes size of one block
+   * @param[in] count number of blocks
+   * @param[out] ptrs array to store pointers to allocated blocks
+   */
+  virtual void alloc_n(size_t numOfBytes, size_t count, void **ptrs) {
+    size_t i = 0;
+    try {
+      for (; i < count; i++)
+        ptrs[i] = alloc(numOfBytes);
+    }
+    catch (...) {
+      dealloc_n_sized(ptrs, i, numOfBytes);
+      throw;
+    }
+  }
+
+  /**
+   * Dealocation of several blocks function.
+   * Default implementation deallocates blocks one by one.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   */
+  virtual void dealloc_n(void **ptrs, size_t count) {
+    for (size_t i = 0; i < count; i++)
+      dealloc(ptrs[i]);
+  }
+
+  /**
+   * Dealocation of several blocks of one size function.
+   * Default implementation ignores size.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   * @param[in] numOfBytes size of one block given to allocation
+   */
+  virtual void dealloc_n_sized(void **ptrs, size_t count, size_t numOfBytes) {
+    dealloc_n(ptrs, count);
+  }
+
+  /**
+   * Allocation with memory block size and alignment function.
+   * Default implementation allocates block with space for alignment
+   * and stores pointer to allocated block just before aligned one.
+   * @param[in] numOfBytes number of bytes to push
+   * @param[in] alignment power of 2 block alignment
+   * @return pointer to allocated memory
+   */
+  virtual void *alloc_aligned(size_t numOfBytes, size_t alignment) {
+    if (alignment <= defaultAlignment)
+      return alloc(numOfBytes);
+    void *block = alloc(AlignedBlockSize(numOfBytes, alignment));
+    uintptr_t aligned = (reinterpret_cast<uintptr_t>(block) + sizeof(void *) + alignment - 1) & ~(alignment - 1);
+    reinterpret_cast<void **>(aligned)[-1] = block;
+    return reinterpret_cast<void *>(aligned);
+  }
+
+  /**
+   * Dealocation with pointer, block size and alignment function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   * @param[in] alignment block alignment given to allocation
+   */
+  virtual void dealloc_aligned(void *ptr, size_t numOfBytes, size_t alignment) {
+    if (alignment <= defaultAlignment)
+      dealloc_sized(ptr, numOfBytes);
+    else if (ptr != nullptr)
+      dealloc_sized(static_cast<void **>(ptr)[-1], AlignedBlockSize(numOfBytes, alignment));
+  }
+
+  /**
+   * Allocation of several memory blocks of one size and alignment function.
+   * Default implementation allocates blocks one by one.
+   * @param[in] numOfBytes size of one block
+   * @param[in] alignment power of 2 block alignment
+   * @param[in] count number of blocks
+   * @param[out] ptrs array to store pointers to allocated blocks
+   */
+  virtual void alloc_n_aligned(size_t numOfBytes, size_t alignment, size_t count, void **ptrs) {
+    if (alignment <= defaultAlignment) {
+      alloc_n(numOfBytes, count, ptrs);
+      return;
+    }
+    size_t i = 0;
+    try {
+      for (; i < count; i++)
+        ptrs[i] = alloc_aligned(numOfBytes, alignment);
+    }
+    catch (...) {
+      dealloc_n_aligned(ptrs, i, numOfBytes, alignment);
+      throw;
+    }
+  }
+
+  /**
+   * Dealocation of several blocks of one size and alignment function.
+   * Default implementation deallocates blocks one by one.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   * @param[in] numOfBytes size of one block given to allocation
+   * @param[in] alignment blocks alignment given to allocation
+   */
+  virtual void dealloc_n_aligned(void **ptrs, size_t count, size_t numOfBytes, size_t alignment) {
+    if (alignment <= defaultAlignment) {
+      dealloc_n_sized(ptrs, count, numOfBytes);
+      return;
+    }
+    for (size_t i = 0; i < count; i++)
+      dealloc_aligned(ptrs[i], numOfBytes, alignment);
+  }
+
+  /**
+   * Free all blocks at once function.
+   * On success all blocks allocated by strategy become invalid and must not be deallocated.
+   * Default implementation frees nothing.
+   * @return true if all blocks are freed, false if bulk release is not supported
+   */
+  virtual bool release(void) {
+    return false;
+  }
+
+  /**
+   * Take ownership of all memory of another strategy function.
+   * On success all blocks allocated by 'source' must be deallocated with this strategy,
+   * 'source' owns nothing and may be destroyed or used for new blocks.
+   * Default implementation takes nothing.
+   * @param[in] source strategy to take memory from
+   * @return true if memory is taken, false if strategies are not compatible
+   */
+  virtual bool absorb(alloc_strategy_t &source) {
+    return false;
+  }
+
   /**
    * Destructor.
    */
   virtual ~alloc_strategy_t(void) = 0 {
   }
+
+protected:
+  /**
+   * Get size of block with space for alignment by default implementation function.
+   * @param[in] numOfBytes number of bytes to push
+   * @param[in] alignment block alignment
+   * @return size of block to allocate
+   */
+  static size_t AlignedBlockSize(size_t numOfBytes, size_t alignment) {
+    return numOfBytes + alignment - 1 + sizeof(void *);
+  }
 };
 
 #endif /* __ALLOC_STRATEGY_H_INCLUDED */
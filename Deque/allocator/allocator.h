@@ -11,59 +11,254 @@
 #ifndef __ALLOCATOR_H_INCLUDED
 #define __ALLOCATOR_H_INCLUDED
 
+#include <memory>
+
 #include "alloc_strategy.h"
 
+/**
+ * @brief Static allocation strategy holder class.
+ * @tparam Strategy allocation strategy type
+ *
+ * Holder has no state: all holders of one 'Strategy' type use its single static instance,
+ * so strategy calls are direct (final or non-virtual) and can be inlined.
+ * Instance is shared by all containers and threads of process, so 'Strategy' must be thread safe
+ * ('isThreadSafe' flag), e.g. 'synchronized_strategy_t<pool_strategy_t>'.
+ * Instance is created on first use and never destroyed, so containers with static lifetime
+ * may free nodes into it on exit regardless of destruction order.
+ */
+template <typename Strategy>
+class strategy_holder_t {
+  static_assert(Strategy::isThreadSafe, "Static strategy is shared by all threads, use thread safe strategy, e.g. 'synchronized_strategy_t'");
+
+public:
+  static constexpr bool isDynamic = false;  ///< strategy can be changed at runtime flag
+
+  /**
+   * Get static strategy instance function.
+   * @return reference to strategy
+   */
+  static Strategy &Instance(void) {
+    static Strategy &strategy = *new Strategy();
+    return strategy;
+  }
+
+  /**
+   * Get strategy function.
+   * @return pointer to strategy
+   */
+  Strategy *get(void) const {
+    return &Instance();
+  }
+
+  /**
+   * Check holder is the only user of strategy function.
+   * @return false, static strategy instance is shared by all holders
+   */
+  bool unique(void) const {
+    return false;
+  }
+};
+
+/**
+ * @brief Runtime allocation strategy holder class.
+ *
+ * Holds shared strategy which is called through virtual interface and can be changed at runtime.
+ */
+template <>
+class strategy_holder_t<alloc_strategy_t> {
+private:
+  std::shared_ptr<alloc_strategy_t> strategy;  ///< held strategy
+
+public:
+  static constexpr bool isDynamic = true;  ///< strategy can be changed at runtime flag
+
+  /**
+   * Constructor.
+   * @param[in] s allocation strategy
+   */
+  strategy_holder_t(std::shared_ptr<alloc_strategy_t> const &s) : strategy(s) {
+  }
+
+  /**
+   * Get strategy function.
+   * @return pointer to strategy
+   */
+  alloc_strategy_t *get(void) const {
+    return strategy.get();
+  }
+
+  /**
+   * Check holder is the only user of strategy function.
+   * @return true if no other holder shares strategy, false - otherwise
+   */
+  bool unique(void) const {
+    return strategy.use_count() == 1;
+  }
+
+  /**
+   * Get shared strategy function.
+   * @return reference to shared pointer to strategy
+   */
+  std::shared_ptr<alloc_strategy_t> const &shared(void) const {
+    return strategy;
+  }
+};
+
 /**
  * @brief Single instances allocator class.
  * @tparam T type to allocate
+ * @tparam Strategy allocation strategy type, 'alloc_strategy_t' means runtime strategy
  *
  * Class to allocate instances of 'T' type with constructors.
+ * With runtime strategy allocator holds shared strategy given to constructor,
+ * with any other strategy type it uses static strategy instance without virtual dispatch.
+ * Over-aligned types are allocated with aligned strategy functions.
  */
-template <typename T>
+template <typename T, typename Strategy = alloc_strategy_t>
 class single_allocator_t {
+  template <typename U, typename S>
+  friend class single_allocator_t;
+
 private:
-  std::shared_ptr<alloc_strategy_t> allocStrategy;  ///< allocation strategy used by allocator
+  static constexpr bool isOverAligned = alignof(T) > alloc_strategy_t::defaultAlignment;  ///< type needs aligned allocation flag
+
+  strategy_holder_t<Strategy> allocStrategy;  ///< allocation strategy used by allocator
+
+  /**
+   * Allocate memory block for T type instances function.
+   * @param[in] numOfBytes block size
+   * @return pointer to allocated memory
+   */
+  void *AllocBlock(size_t numOfBytes) {
+    if constexpr (isOverAligned)
+      return allocStrategy.get()->alloc_aligned(numOfBytes, alignof(T));
+    else
+      return allocStrategy.get()->alloc(numOfBytes);
+  }
+
+  /**
+   * Deallocate memory block of T type instances function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   */
+  void DeallocBlock(void *ptr, size_t numOfBytes) {
+    if constexpr (isOverAligned)
+      allocStrategy.get()->dealloc_aligned(ptr, numOfBytes, alignof(T));
+    else
+      allocStrategy.get()->dealloc_sized(ptr, numOfBytes);
+  }
 
 public:
   /**
-   * Deleted default constructor.
+   * Default constructor. Available only for static strategy.
    */
-  single_allocator_t(void) = delete;
+  single_allocator_t(void) {
+    static_assert(!strategy_holder_t<Strategy>::isDynamic, "Runtime strategy allocator needs strategy to construct");
+  }
 
   /**
    * Copy constructor.
    * @param[in] lhs instance to copy
    */
-  single_allocator_t(single_allocator_t<T> const &lhs) = default;
+  single_allocator_t(single_allocator_t const &lhs) = default;
 
   /**
    * Move constructor.
    * @param[in] rhs rValue reference to copy
    */
-  single_allocator_t(single_allocator_t<T> &&rhs) = default;
+  single_allocator_t(single_allocator_t &&rhs) = default;
 
   /**
    * Copy operator=.
    * @param[in] lhs instance to copy
    * @return reference to this instance
    */
-  single_allocator_t<T>& operator=(single_allocator_t<T> const &lhs) = default;
+  single_allocator_t& operator=(single_allocator_t const &lhs) = default;
 
   /**
    * Move operator=.
    * @param[in] rhs rValue reference to copy
    * @return reference to this instance
    */
-  single_allocator_t<T>& operator=(single_allocator_t<T> &&rhs) = default;
+  single_allocator_t& operator=(single_allocator_t &&rhs) = default;
 
   /**
-   * Constructor.
+   * Constructor. Available only for runtime strategy.
    * @param strategy allocation strategy
    */
   single_allocator_t(std::shared_ptr<alloc_strategy_t> const &strategy) :
     allocStrategy(strategy) {
   }
 
+  /**
+   * Constructor by allocator of another type. Uses the same strategy.
+   * @tparam U another allocator type
+   * @param[in] lhs allocator to take strategy from
+   */
+  template <typename U>
+  explicit single_allocator_t(single_allocator_t<U, Strategy> const &lhs) :
+    allocStrategy(lhs.allocStrategy) {
+  }
+
+  /**
+   * Equality operator. Allocators are equal if they use the same strategy instance,
+   * so memory allocated by one of them can be freed by another.
+   * @param[in] lhs allocator to compare
+   * @return true if allocators are equal, false - otherwise
+   */
+  bool operator==(single_allocator_t const &lhs) const {
+    return allocStrategy.get() == lhs.allocStrategy.get();
+  }
+
+  /**
+   * Inequality operator.
+   * @param[in] lhs allocator to compare
+   * @return true if allocators use different strategies, false - otherwise
+   */
+  bool operator!=(single_allocator_t const &lhs) const {
+    return !(*this == lhs);
+  }
+
+  /**
+   * Move allocator with all allocated memory to another strategy function. Available only for runtime strategy.
+   * Memory is moved only if this allocator is the only owner of its strategy and new strategy absorbs it,
+   * then all instances allocated before stay valid and are deallocated with new strategy.
+   * @param[in] strategy new allocation strategy
+   * @return true if allocator is moved, false if allocator is not changed
+   */
+  bool migrate(std::shared_ptr<alloc_strategy_t> const &strategy) {
+    std::shared_ptr<alloc_strategy_t> const &current = allocStrategy.shared();
+    if (current != strategy && (!allocStrategy.unique() || !strategy->absorb(*current)))
+      return false;
+    if constexpr (alloc_stats_t::isEnabled)
+      strategy->stats().OnAbsorb(current->stats());
+    allocStrategy = strategy_holder_t<Strategy>(strategy);
+    return true;
+  }
+
+  /**
+   * Free all memory of strategy at once function.
+   * Memory is freed only if this allocator is the only owner of runtime strategy and strategy supports bulk release,
+   * then all instances allocated before become invalid and are not destroyed.
+   * @return true if memory is freed, false - otherwise
+   */
+  bool release(void) {
+    if (!allocStrategy.unique() || !allocStrategy.get()->release())
+      return false;
+    if constexpr (alloc_stats_t::isEnabled)
+      allocStrategy.get()->stats().OnRelease();
+    return true;
+  }
+
+  /**
+   * Get allocation statistics of strategy function.
+   * Statistics are collected only if DEQUE_ALLOC_STATS macro is defined.
+   * @return reference to statistics
+   */
+  alloc_stats_t &stats(void) const {
+    return allocStrategy.get()->stats();
+  }
+
   /**
    * Allocation T type instance function.
    * @tparam Args constructor argument types
@@ -72,7 +267,10 @@ public:
    */
   template <typename... Args>
   T *alloc(Args&&... constructorArgs) {
-    T* ptr = static_cast<T*>(allocStrategy->alloc(sizeof(T)));
+    alloc_timer_t timer;
+    T* ptr = static_cast<T*>(AllocBlock(sizeof(T)));
+    if constexpr (alloc_stats_t::isEnabled)
+      allocStrategy.get()->stats().OnAlloc(sizeof(T), 1, timer.Elapsed());
     new (ptr) T(std::forward<Args>(constructorArgs)...);
     return ptr;
   }
@@ -83,7 +281,85 @@ public:
    */
   void dealloc(T *ptr) {
     ptr->~T();
-    allocStrategy->dealloc(ptr);
+    DeallocBlock(ptr, sizeof(T));
+    if constexpr (alloc_stats_t::isEnabled)
+      allocStrategy.get()->stats().OnDealloc(sizeof(T), 1);
+  }
+
+  /**
+   * Allocation of memory for several T type instances without construction function.
+   * @param[in] count number of instances
+   * @param[out] ptrs array to store pointers to allocated memory
+   */
+  void allocRaw(size_t count, T **ptrs) {
+    alloc_timer_t timer;
+    if constexpr (isOverAligned)
+      allocStrategy.get()->alloc_n_aligned(sizeof(T), alignof(T), count, reinterpret_cast<void **>(ptrs));
+    else
+      allocStrategy.get()->alloc_n(sizeof(T), count, reinterpret_cast<void **>(ptrs));
+    if constexpr (alloc_stats_t::isEnabled)
+      allocStrategy.get()->stats().OnAlloc(sizeof(T), count, timer.Elapsed());
+  }
+
+  /**
+   * Deallocation of several T type instances memory without destruction function.
+   * @param[in] ptrs array of pointers to instances
+   * @param[in] count number of instances
+   */
+  void deallocRaw(T **ptrs, size_t count) {
+    if constexpr (isOverAligned)
+      allocStrategy.get()->dealloc_n_aligned(reinterpret_cast<void **>(ptrs), count, sizeof(T), alignof(T));
+    else
+      allocStrategy.get()->dealloc_n_sized(reinterpret_cast<void **>(ptrs), count, sizeof(T));
+    if constexpr (alloc_stats_t::isEnabled)
+      allocStrategy.get()->stats().OnDealloc(sizeof(T), count);
+  }
+
+  /**
+   * Allocation of memory for T type instances array without construction function.
+   * @param[in] count number of instances
+   * @return pointer to allocated array
+   */
+  T *allocArrayRaw(size_t count) {
+    alloc_timer_t timer;
+    T *ptr = static_cast<T*>(AllocBlock(sizeof(T) * count));
+    if constexpr (alloc_stats_t::isEnabled)
+      allocStrategy.get()->stats().OnAlloc(sizeof(T) * count, 1, timer.Elapsed());
+    return ptr;
+  }
+
+  /**
+   * Deallocation of T type instances array memory without destruction function.
+   * @param[in] ptr pointer to array
+   * @param[in] count number of instances
+   */
+  void deallocArrayRaw(T *ptr, size_t count) {
+    DeallocBlock(ptr, sizeof(T) * count);
+    if constexpr (alloc_stats_t::isEnabled)
+      allocStrategy.get()->stats().OnDealloc(sizeof(T) * count, 1);
+  }
+
+  /**
+   * Allocation of value initialized T type instances array function.
+   * @param[in] count number of instances
+   * @return pointer to allocated array
+   */
+  T *allocArray(size_t count) {
+    T *ptr = allocArrayRaw(count);
+    for (size_t i = 0; i < count; i++)
+      new (ptr + i) T();
+    return ptr;
+  }
+
+  /**
+   * Deallocation of T type instances array function.
+   * @param[in] ptr pointer to array
+   * @param[in] count number of instances
+   */
+  void deallocArray(T *ptr, size_t count) {
+    for (size_t i = 0; i < count; i++)
+      ptr[i].~T();
+    deallocArrayRaw(ptr, count);
   }
 };
 
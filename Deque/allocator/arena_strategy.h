@@ -0,0 +1,273 @@
+/**
+ * @file
+ * @brief Arena allocation strategy class header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains class of monotonic strategy that hands out memory from growing chunks with bump pointer
+ */
+
+#pragma once
+
+#ifndef __ARENA_STRATEGY_H_INCLUDED
+#define __ARENA_STRATEGY_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "alloc_strategy.h"
+
+/**
+ * @brief Arena allocation strategy class.
+ *
+ * Monotonic strategy: blocks are cut from chunks with bump pointer and deallocation of one block does nothing.
+ * Memory is freed all at once by release function or destructor,
+ * so arena fits containers which are filled, drained and thrown away.
+ * Every next chunk is twice bigger than previous one.
+ * Over-aligned blocks are cut after padding of bump pointer up to block alignment.
+ */
+class arena_strategy_t : public alloc_strategy_t {
+public:
+  static constexpr size_t defaultChunkSize = 64 * 1024;  ///< default first chunk size
+
+private:
+  static constexpr size_t alignment = alignof(std::max_align_t);  ///< alignment of every block
+
+  /**
+   * @brief Arena chunk header struct.
+   *
+   * Lies at the beginning of every chunk.
+   */
+  struct chunk_t {
+    chunk_t *prev;  ///< previously allocated chunk
+    size_t size;    ///< chunk size with header
+  };
+
+  static constexpr size_t headerSize = (sizeof(chunk_t) + alignment - 1) / alignment * alignment;  ///< chunk header size with alignment
+
+  chunk_t *chunks;   ///< list of chunks from last allocated
+  char
+    *bump,           ///< beginning of free memory in last chunk
+    *end;            ///< last chunk end
+  size_t chunkSize;  ///< size of next chunk
+
+  /**
+   * Round size up to block alignment function.
+   * @param[in] numOfBytes block size
+   * @return aligned block size
+   */
+  static size_t Align(size_t numOfBytes) {
+    return numOfBytes == 0 ? alignment : (numOfBytes + alignment - 1) / alignment * alignment;
+  }
+
+  /**
+   * Allocate new chunk function.
+   * @param[in] numOfBytes aligned size of block which must fit new chunk
+   */
+  void AddChunk(size_t numOfBytes) {
+    while (chunkSize < headerSize + numOfBytes)
+      chunkSize *= 2;
+    chunk_t *chunk = static_cast<chunk_t *>(malloc(chunkSize));
+    if (chunk == nullptr)
+      throw std::bad_alloc();
+    chunk->prev = chunks;
+    chunk->size = chunkSize;
+    chunks = chunk;
+    bump = reinterpret_cast<char *>(chunk) + headerSize;
+    end = reinterpret_cast<char *>(chunk) + chunkSize;
+    chunkSize *= 2;
+  }
+
+  /**
+   * Free chunks list function.
+   * @param[in] chunk list beginning
+   */
+  static void FreeChunks(chunk_t *chunk) {
+    while (chunk != nullptr) {
+      chunk_t *prev = chunk->prev;
+      free(chunk);
+      chunk = prev;
+    }
+  }
+
+public:
+  /**
+   * Constructor.
+   * @param[in] firstChunkSize size of first chunk
+   */
+  explicit arena_strategy_t(size_t firstChunkSize = defaultChunkSize) :
+    chunks(nullptr), bump(nullptr), end(nullptr), chunkSize(firstChunkSize < 2 * headerSize ? 2 * headerSize : firstChunkSize) {
+  }
+
+  /**
+   * Deleted copy constructor.
+   */
+  arena_strategy_t(arena_strategy_t const &) = delete;
+
+  /**
+   * Deleted copy operator=.
+   */
+  arena_strategy_t &operator=(arena_strategy_t const &) = delete;
+
+  /**
+   * Allocation with memory block size function.
+   * @param[in] numOfBytes number of bytes to push
+   * @return pointer to allocated memory
+   */
+  void *alloc(size_t numOfBytes) override final {
+    numOfBytes = Align(numOfBytes);
+    if (static_cast<size_t>(end - bump) < numOfBytes)
+      AddChunk(numOfBytes);
+    void *block = bump;
+    bump += numOfBytes;
+    return block;
+  }
+
+  /**
+   * Dealocation with pointer function. Does nothing, memory is freed by release.
+   * @param[in] ptr pointer to block
+   */
+  void dealloc(void *ptr) override final {
+  }
+
+  /**
+   * Allocation of several memory blocks of one size function.
+   * @param[in] numOfBytes size of one block
+   * @param[in] count number of blocks
+   * @param[out] ptrs array to store pointers to allocated blocks
+   */
+  void alloc_n(size_t numOfBytes, size_t count, void **ptrs) override final {
+    for (size_t i = 0; i < count; i++)
+      ptrs[i] = arena_strategy_t::alloc(numOfBytes);
+  }
+
+  /**
+   * Dealocation of several blocks function. Does nothing, memory is freed by release.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   */
+  void dealloc_n(void **ptrs, size_t count) override final {
+  }
+
+  /**
+   * Dealocation with pointer and block size function. Does nothing, memory is freed by release.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   */
+  void dealloc_sized(void *ptr, size_t numOfBytes) override final {
+  }
+
+  /**
+   * Dealocation of several blocks of one size function. Does nothing, memory is freed by release.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   * @param[in] numOfBytes size of one block given to allocation
+   */
+  void dealloc_n_sized(void **ptrs, size_t count, size_t numOfBytes) override final {
+  }
+
+  /**
+   * Allocation with memory block size and alignment function.
+   * @param[in] numOfBytes number of bytes to push
+   * @param[in] blockAlignment power of 2 block alignment
+   * @return pointer to allocated memory
+   */
+  void *alloc_aligned(size_t numOfBytes, size_t blockAlignment) override final {
+    if (blockAlignment <= alignment)
+      return arena_strategy_t::alloc(numOfBytes);
+    numOfBytes = Align(numOfBytes);
+    size_t padding = (0 - reinterpret_cast<uintptr_t>(bump)) & (blockAlignment - 1);
+    if (bump == nullptr || static_cast<size_t>(end - bump) < padding + numOfBytes) {
+      AddChunk(numOfBytes + blockAlignment);
+      padding = (0 - reinterpret_cast<uintptr_t>(bump)) & (blockAlignment - 1);
+    }
+    void *block = bump + padding;
+    bump += padding + numOfBytes;
+    return block;
+  }
+
+  /**
+   * Dealocation with pointer, block size and alignment function. Does nothing, memory is freed by release.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   * @param[in] blockAlignment block alignment given to allocation
+   */
+  void dealloc_aligned(void *ptr, size_t numOfBytes, size_t blockAlignment) override final {
+  }
+
+  /**
+   * Allocation of several memory blocks of one size and alignment function.
+   * @param[in] numOfBytes size of one block
+   * @param[in] blockAlignment power of 2 block alignment
+   * @param[in] count number of blocks
+   * @param[out] ptrs array to store pointers to allocated blocks
+   */
+  void alloc_n_aligned(size_t numOfBytes, size_t blockAlignment, size_t count, void **ptrs) override final {
+    for (size_t i = 0; i < count; i++)
+      ptrs[i] = arena_strategy_t::alloc_aligned(numOfBytes, blockAlignment);
+  }
+
+  /**
+   * Dealocation of several blocks of one size and alignment function. Does nothing, memory is freed by release.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   * @param[in] numOfBytes size of one block given to allocation
+   * @param[in] blockAlignment blocks alignment given to allocation
+   */
+  void dealloc_n_aligned(void **ptrs, size_t count, size_t numOfBytes, size_t blockAlignment) override final {
+  }
+
+  /**
+   * Free all blocks at once function.
+   * Last and biggest chunk is kept for next allocations.
+   * @return true
+   */
+  bool release(void) override final {
+    if (chunks == nullptr)
+      return true;
+    FreeChunks(chunks->prev);
+    chunks->prev = nullptr;
+    bump = reinterpret_cast<char *>(chunks) + headerSize;
+    return true;
+  }
+
+  /**
+   * Take ownership of all memory of another strategy function.
+   * Chunks of another arena strategy are linked to this arena list, other strategies are not compatible.
+   * @param[in] source strategy to take memory from
+   * @return true if memory is taken, false if strategies are not compatible
+   */
+  bool absorb(alloc_strategy_t &source) override final {
+    arena_strategy_t *lhs = dynamic_cast<arena_strategy_t *>(&source);
+    if (lhs == nullptr)
+      return false;
+    if (lhs == this || lhs->chunks == nullptr)
+      return true;
+    if (chunks == nullptr) {
+      chunks = lhs->chunks;
+      bump = lhs->bump;
+      end = lhs->end;
+    }
+    else {
+      chunk_t *oldest = lhs->chunks;
+      while (oldest->prev != nullptr)
+        oldest = oldest->prev;
+      oldest->prev = chunks->prev;
+      chunks->prev = lhs->chunks;
+    }
+    lhs->chunks = nullptr;
+    lhs->bump = nullptr;
+    lhs->end = nullptr;
+    return true;
+  }
+
+  /**
+   * Destructor.
+   */
+  ~arena_strategy_t(void) {
+    FreeChunks(chunks);
+  }
+};
+
+#endif /* __ARENA_STRATEGY_H_INCLUDED */
@@ -0,0 +1,351 @@
+/**
+ * @file
+ * @brief Mapped file allocation strategy class header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains class of strategy that hands out blocks of memory mapped file
+ * addressed by offsets, so data survives process restart
+ */
+
+#pragma once
+
+#ifndef __MAPPED_FILE_STRATEGY_H_INCLUDED
+#define __MAPPED_FILE_STRATEGY_H_INCLUDED
+
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "alloc_strategy.h"
+
+/**
+ * @brief Memory mapped file class.
+ *
+ * Maps whole file for reading and writing, new or empty file is extended to given size.
+ * Mapping is shared with file, so changes reach file without explicit writes.
+ */
+class mapped_file_t {
+private:
+#ifdef _WIN32
+  HANDLE
+    file,                  ///< file handle
+    mapping;               ///< file mapping handle
+#else
+  int file;                ///< file descriptor
+#endif
+  void *data;              ///< mapped file beginning
+  size_t size;             ///< mapped file size
+  bool created;            ///< file was empty on opening flag
+
+  /**
+   * Close file and mapping function.
+   */
+  void Close(void) {
+#ifdef _WIN32
+    if (data != nullptr)
+      UnmapViewOfFile(data);
+    if (mapping != nullptr)
+      CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE)
+      CloseHandle(file);
+#else
+    if (data != nullptr)
+      munmap(data, size);
+    if (file >= 0)
+      close(file);
+#endif
+  }
+
+public:
+  /**
+   * Constructor. Opens or creates file and maps it.
+   * @param[in] path file path
+   * @param[in] newFileSize size of created or empty file, existing file keeps its size
+   */
+  mapped_file_t(std::string const &path, size_t newFileSize) : data(nullptr), size(0), created(false) {
+#ifdef _WIN32
+    mapping = nullptr;
+    file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER fileSize;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize)) {
+      Close();
+      throw std::exception("Can't open mapped file");
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    created = size == 0;
+    if (created)
+      size = newFileSize;
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32),
+      static_cast<DWORD>(size), nullptr);
+    if (mapping != nullptr)
+      data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (data == nullptr) {
+      Close();
+      throw std::exception("Can't map file");
+    }
+#else
+    file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat fileStat;
+    if (file < 0 || fstat(file, &fileStat) != 0) {
+      Close();
+      throw std::exception("Can't open mapped file");
+    }
+    size = static_cast<size_t>(fileStat.st_size);
+    created = size == 0;
+    if (created) {
+      size = newFileSize;
+      if (ftruncate(file, static_cast<off_t>(size)) != 0) {
+        Close();
+        throw std::exception("Can't extend mapped file");
+      }
+    }
+    void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (mapped == MAP_FAILED) {
+      Close();
+      throw std::exception("Can't map file");
+    }
+    data = mapped;
+#endif
+  }
+
+  /**
+   * Deleted copy constructor.
+   */
+  mapped_file_t(mapped_file_t const &) = delete;
+
+  /**
+   * Deleted copy operator =.
+   */
+  mapped_file_t &operator=(mapped_file_t const &) = delete;
+
+  /**
+   * Get mapped file beginning function.
+   * @return pointer to first byte
+   */
+  void *Data(void) const {
+    return data;
+  }
+
+  /**
+   * Get mapped file size function.
+   * @return number of bytes
+   */
+  size_t Size(void) const {
+    return size;
+  }
+
+  /**
+   * Get file was empty on opening flag function.
+   * @return true if file is new, false - otherwise
+   */
+  bool IsCreated(void) const {
+    return created;
+  }
+
+  /**
+   * Write changed pages to file and wait for it function.
+   */
+  void Flush(void) {
+#ifdef _WIN32
+    if (!FlushViewOfFile(data, 0) || !FlushFileBuffers(file))
+      throw std::exception("Can't flush mapped file");
+#else
+    if (msync(data, size, MS_SYNC) != 0)
+      throw std::exception("Can't flush mapped file");
+#endif
+  }
+
+  /**
+   * Destructor.
+   */
+  ~mapped_file_t(void) {
+    Close();
+  }
+};
+
+/**
+ * @brief Mapped file allocation strategy class.
+ *
+ * Strategy cuts blocks from memory mapped file and keeps all bookkeeping inside the file,
+ * so blocks and their contents are found again after file is reopened, possibly at another address.
+ * Blocks are addressed by offsets from file beginning (see 'offset' and 'address'), offset 0 is null.
+ * Block sizes with 16-byte block header are rounded up to powers of 2, freed blocks are kept
+ * in per size class lists and taken in O(1), new blocks are cut from file end.
+ * File size is fixed on creation: mapping is never moved while blocks are used, allocation throws when file is full.
+ * Blocks are aligned to 16 bytes, greater alignment is served by base class with blocks which are not relocatable.
+ * File header has several root slots to find data structures on reopening (see 'persistent_deque_t').
+ * Strategy has no synchronization, use 'synchronized_strategy_t' to share it between threads.
+ */
+class mapped_file_strategy_t : public alloc_strategy_t {
+public:
+  static constexpr size_t
+    numOfRoots = 8,                  ///< number of root slots in file header
+    blockAlignment = 16;             ///< blocks alignment
+
+private:
+  static constexpr std::uint64_t mark = 0x3153544150514544;  ///< file format mark, "DEQPATS1" in little endian
+  static constexpr size_t
+    numOfClasses = 64,               ///< number of size classes
+    minClass = 5,                    ///< smallest size class, block of 32 bytes
+    blockHeaderSize = 16;            ///< block header size, keeps blocks aligned
+
+  /**
+   * @brief File header struct.
+   */
+  struct file_header_t {
+    std::uint64_t
+      fileMark,                      ///< file format mark
+      fileSize,                      ///< file size on creation
+      top,                           ///< offset of not used file part
+      freeLists[numOfClasses],       ///< offsets of first free blocks of size classes
+      roots[numOfRoots];             ///< root slots
+  };
+
+  mapped_file_t file;                ///< mapped file
+  file_header_t *header;             ///< file header at mapping beginning
+
+  /**
+   * Get size class of block function.
+   * @param[in] numOfBytes block size without header
+   * @return size class, block with header takes 2 to power of class bytes, 'numOfClasses' if block is too big
+   */
+  static size_t SizeClass(size_t numOfBytes) {
+    size_t sizeClass = minClass;
+    while (sizeClass < numOfClasses && (size_t(1) << sizeClass) - blockHeaderSize < numOfBytes)
+      sizeClass++;
+    return sizeClass;
+  }
+
+public:
+  /**
+   * Constructor. Opens file or creates it with empty header.
+   * @param[in] path file path
+   * @param[in] fileSize size of created file
+   */
+  mapped_file_strategy_t(std::string const &path, size_t fileSize) :
+    file(path, fileSize), header(static_cast<file_header_t *>(file.Data())) {
+    if (file.IsCreated()) {
+      if (file.Size() < sizeof(file_header_t))
+        throw std::exception("Mapped file is too small");
+      *header = file_header_t();
+      header->fileSize = file.Size();
+      header->top = (sizeof(file_header_t) + blockAlignment - 1) / blockAlignment * blockAlignment;
+      header->fileMark = mark;
+    }
+    else if (file.Size() < sizeof(file_header_t) || header->fileMark != mark || header->fileSize != file.Size())
+      throw std::exception("Not a mapped strategy file");
+  }
+
+  /**
+   * Get offset of block function.
+   * @param[in] ptr pointer inside mapped file, may be nullptr
+   * @return offset from file beginning, 0 for nullptr
+   */
+  std::uint64_t offset(void const *ptr) const {
+    return ptr == nullptr ? 0 : static_cast<std::uint64_t>(static_cast<unsigned char const *>(ptr) - static_cast<unsigned char const *>(file.Data()));
+  }
+
+  /**
+   * Get block by offset function.
+   * @param[in] blockOffset offset from file beginning, may be 0
+   * @return pointer to block, nullptr for offset 0
+   */
+  void *address(std::uint64_t blockOffset) const {
+    return blockOffset == 0 ? nullptr : static_cast<unsigned char *>(file.Data()) + blockOffset;
+  }
+
+  /**
+   * Get root slot function.
+   * @param[in] index root slot index, less than 'numOfRoots'
+   * @return reference to slot in file header, slots of new file are 0
+   */
+  std::uint64_t &root(size_t index) {
+    if (index >= numOfRoots)
+      throw std::exception("Root index out of range");
+    return header->roots[index];
+  }
+
+  /**
+   * Write changed pages to file and wait for it function.
+   */
+  void flush(void) {
+    file.Flush();
+  }
+
+  /**
+   * Allocation with memory block size function.
+   * @param[in] numOfBytes number of bytes to push
+   * @return pointer to allocated memory
+   */
+  void *alloc(size_t numOfBytes) override final {
+    size_t sizeClass = SizeClass(numOfBytes);
+    if (sizeClass >= numOfClasses)
+      throw std::bad_alloc();
+    std::uint64_t block = header->freeLists[sizeClass];
+    if (block != 0)
+      header->freeLists[sizeClass] = *static_cast<std::uint64_t *>(address(block + blockHeaderSize));
+    else {
+      std::uint64_t blockSize = std::uint64_t(1) << sizeClass;
+      if (blockSize > header->fileSize - header->top)
+        throw std::bad_alloc();
+      block = header->top;
+      header->top += blockSize;
+    }
+    *static_cast<std::uint64_t *>(address(block)) = sizeClass;
+    return address(block + blockHeaderSize);
+  }
+
+  /**
+   * Dealocation with pointer function.
+   * @param[in] ptr pointer to block
+   */
+  void dealloc(void *ptr) override final {
+    if (ptr == nullptr)
+      return;
+    std::uint64_t block = offset(ptr) - blockHeaderSize;
+    size_t sizeClass = static_cast<size_t>(*static_cast<std::uint64_t *>(address(block)));
+    *static_cast<std::uint64_t *>(ptr) = header->freeLists[sizeClass];
+    header->freeLists[sizeClass] = block;
+  }
+
+  /**
+   * Allocation with memory block size and alignment function.
+   * Blocks are relocatable only with alignment up to 'blockAlignment'.
+   * @param[in] numOfBytes number of bytes to push
+   * @param[in] alignment power of 2 block alignment
+   * @return pointer to allocated memory
+   */
+  void *alloc_aligned(size_t numOfBytes, size_t alignment) override final {
+    if (alignment <= blockAlignment)
+      return mapped_file_strategy_t::alloc(numOfBytes);
+    return alloc_strategy_t::alloc_aligned(numOfBytes, alignment);
+  }
+
+  /**
+   * Dealocation with pointer, block size and alignment function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   * @param[in] alignment block alignment given to allocation
+   */
+  void dealloc_aligned(void *ptr, size_t numOfBytes, size_t alignment) override final {
+    if (alignment <= blockAlignment)
+      mapped_file_strategy_t::dealloc(ptr);
+    else
+      alloc_strategy_t::dealloc_aligned(ptr, numOfBytes, alignment);
+  }
+};
+
+#endif /* __MAPPED_FILE_STRATEGY_H_INCLUDED */
@@ -0,0 +1,349 @@
+/**
+ * @file
+ * @brief NUMA allocation strategy class header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains NUMA node bound slab regions source and pool strategy with it
+ */
+
+#pragma once
+
+#ifndef __NUMA_STRATEGY_H_INCLUDED
+#define __NUMA_STRATEGY_H_INCLUDED
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "pool_strategy.h"
+
+/**
+ * @brief NUMA node slab regions source class.
+ *
+ * Source maps memory directly from system and binds it to one NUMA node,
+ * optionally with 2MB huge pages.
+ * Slab regions are cut from chunks of 'chunkSize' and reused after free, chunks are unmapped on destruction,
+ * regions of other sizes are mapped and unmapped one by one.
+ * On Linux pages are bound with mbind system call and huge pages are explicit (MAP_HUGETLB) if system has them reserved,
+ * transparent otherwise. On Windows memory is allocated for preferred node with large pages if process may lock memory.
+ * Binding is made by system as a hint: if system has no NUMA support memory is used without binding.
+ */
+class numa_regions_t {
+public:
+  static constexpr size_t
+    hugePageSize = 2 * 1024 * 1024,  ///< huge page size
+    chunkSize = 2 * 1024 * 1024;     ///< size of chunks slab regions are cut from
+
+private:
+#ifndef _WIN32
+  static constexpr int
+    mpolBind = 2;                    ///< strict binding memory policy (MPOL_BIND)
+  static constexpr unsigned
+    mpolMoveFlag = 1 << 1;           ///< move existing pages flag (MPOL_MF_MOVE)
+  static constexpr size_t
+    maskWords = 16;                  ///< number of words in node mask
+#endif
+
+  int node;                                   ///< NUMA node
+  bool hugePages;                             ///< use huge pages flag
+  std::vector<void *>
+    chunks,                                   ///< mapped chunks
+    freeSlabs;                                ///< freed slab regions
+  std::unordered_map<void *, size_t> mapped;  ///< regions mapped one by one with mapping sizes
+  char
+    *cut,                                     ///< beginning of not used part of last chunk
+    *cutEnd;                                  ///< last chunk end
+
+  /**
+   * Round region size up to mapping granularity function.
+   * @param[in] numOfBytes region size
+   * @return mapping size
+   */
+  size_t MappingSize(size_t numOfBytes) const {
+    return hugePages ? (numOfBytes + hugePageSize - 1) / hugePageSize * hugePageSize : numOfBytes;
+  }
+
+#ifdef _WIN32
+  /**
+   * Map memory on node function.
+   * @param[in] numOfBytes mapping size
+   * @param[in] alignment mapping alignment
+   * @return pointer to mapped memory, nullptr if there is no memory
+   */
+  void *Map(size_t numOfBytes, size_t alignment) {
+    HANDLE process = GetCurrentProcess();
+    if (hugePages && GetLargePageMinimum() != 0 && hugePageSize % GetLargePageMinimum() == 0) {
+      void *result = VirtualAllocExNuma(process, nullptr, numOfBytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+        PAGE_READWRITE, static_cast<DWORD>(node));
+      if (result != nullptr)
+        return result;
+    }
+    // reserve bigger range to find aligned address and map there, other thread may take it between calls
+    for (int attempt = 0; attempt < 8; attempt++) {
+      void *range = VirtualAlloc(nullptr, numOfBytes + alignment, MEM_RESERVE, PAGE_NOACCESS);
+      if (range == nullptr)
+        return nullptr;
+      uintptr_t aligned = (reinterpret_cast<uintptr_t>(range) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+      VirtualFree(range, 0, MEM_RELEASE);
+      void *result = VirtualAllocExNuma(process, reinterpret_cast<void *>(aligned), numOfBytes, MEM_RESERVE | MEM_COMMIT,
+        PAGE_READWRITE, static_cast<DWORD>(node));
+      if (result != nullptr)
+        return result;
+    }
+    return nullptr;
+  }
+
+  /**
+   * Unmap memory function.
+   * @param[in] ptr pointer to mapped memory
+   * @param[in] numOfBytes mapping size
+   */
+  static void Unmap(void *ptr, size_t numOfBytes) {
+    VirtualFree(ptr, 0, MEM_RELEASE);
+  }
+
+  /**
+   * Move mapped memory pages to node function. Pages can not be moved on Windows.
+   * @param[in] ptr pointer to mapped memory
+   * @param[in] numOfBytes mapping size
+   * @return false
+   */
+  bool MovePages(void *ptr, size_t numOfBytes) {
+    return false;
+  }
+#else
+  /**
+   * Bind mapped memory to node function.
+   * @param[in] ptr pointer to mapped memory
+   * @param[in] numOfBytes mapping size
+   * @param[in] flags mbind flags
+   * @return true if memory is bound, false - otherwise
+   */
+  bool Bind(void *ptr, size_t numOfBytes, unsigned flags) {
+    unsigned long mask[maskWords] = {};
+    size_t wordBits = sizeof(unsigned long) * 8;
+    if (node < 0 || static_cast<size_t>(node) >= maskWords * wordBits)
+      return false;
+    mask[node / wordBits] |= 1UL << (node % wordBits);
+    return syscall(SYS_mbind, ptr, numOfBytes, mpolBind, mask, maskWords * wordBits + 1, flags) == 0;
+  }
+
+  /**
+   * Map memory on node function.
+   * @param[in] numOfBytes mapping size
+   * @param[in] alignment mapping alignment, not greater than huge page size
+   * @return pointer to mapped memory, nullptr if there is no memory
+   */
+  void *Map(size_t numOfBytes, size_t alignment) {
+    void *result = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (hugePages)
+      result = mmap(nullptr, numOfBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+    if (result == MAP_FAILED) {
+      if (hugePages)
+        alignment = hugePageSize;
+      // map bigger range and unmap unaligned head and tail
+      void *range = mmap(nullptr, numOfBytes + alignment, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (range == MAP_FAILED)
+        return nullptr;
+      uintptr_t
+        begin = reinterpret_cast<uintptr_t>(range),
+        aligned = (begin + alignment - 1) & ~(uintptr_t)(alignment - 1);
+      if (aligned != begin)
+        munmap(range, aligned - begin);
+      if (begin + alignment != aligned)
+        munmap(reinterpret_cast<void *>(aligned + numOfBytes), begin + alignment - aligned);
+      result = reinterpret_cast<void *>(aligned);
+#ifdef MADV_HUGEPAGE
+      if (hugePages)
+        madvise(result, numOfBytes, MADV_HUGEPAGE);
+#endif
+    }
+    Bind(result, numOfBytes, 0);
+    return result;
+  }
+
+  /**
+   * Unmap memory function.
+   * @param[in] ptr pointer to mapped memory
+   * @param[in] numOfBytes mapping size
+   */
+  static void Unmap(void *ptr, size_t numOfBytes) {
+    munmap(ptr, numOfBytes);
+  }
+
+  /**
+   * Move mapped memory pages to node function.
+   * @param[in] ptr pointer to mapped memory
+   * @param[in] numOfBytes mapping size
+   * @return true if pages are moved, false - otherwise
+   */
+  bool MovePages(void *ptr, size_t numOfBytes) {
+    return Bind(ptr, numOfBytes, mpolMoveFlag);
+  }
+#endif
+
+public:
+  /**
+   * Constructor.
+   * @param[in] numaNode NUMA node to bind memory to
+   * @param[in] useHugePages use huge pages flag
+   */
+  explicit numa_regions_t(int numaNode = 0, bool useHugePages = false) :
+    node(numaNode), hugePages(useHugePages), cut(nullptr), cutEnd(nullptr) {
+  }
+
+  /**
+   * Move constructor.
+   * @param[in] rhs source to move
+   */
+  numa_regions_t(numa_regions_t &&rhs) :
+    node(rhs.node), hugePages(rhs.hugePages), chunks(std::move(rhs.chunks)), freeSlabs(std::move(rhs.freeSlabs)),
+    mapped(std::move(rhs.mapped)), cut(rhs.cut), cutEnd(rhs.cutEnd) {
+    rhs.chunks.clear();
+    rhs.freeSlabs.clear();
+    rhs.mapped.clear();
+    rhs.cut = nullptr;
+    rhs.cutEnd = nullptr;
+  }
+
+  /**
+   * Deleted copy constructor.
+   */
+  numa_regions_t(numa_regions_t const &) = delete;
+
+  /**
+   * Deleted copy operator=.
+   */
+  numa_regions_t &operator=(numa_regions_t const &) = delete;
+
+  /**
+   * Get NUMA node function.
+   * @return NUMA node
+   */
+  int Node(void) const {
+    return node;
+  }
+
+  /**
+   * Aligned region allocation function.
+   * Regions of alignment size are cut from chunks, others are mapped.
+   * @param[in] numOfBytes region size, multiple of alignment
+   * @param[in] alignment region alignment, divisor of chunk size
+   * @return pointer to allocated region, nullptr if there is no memory
+   */
+  void *Alloc(size_t numOfBytes, size_t alignment) {
+    if (numOfBytes != alignment) {
+      size_t mappingSize = MappingSize(numOfBytes);
+      mapped.reserve(mapped.size() + 1);
+      void *region = Map(mappingSize, alignment);
+      if (region != nullptr)
+        mapped.emplace(region, mappingSize);
+      return region;
+    }
+    if (!freeSlabs.empty()) {
+      void *region = freeSlabs.back();
+      freeSlabs.pop_back();
+      return region;
+    }
+    if (cut == cutEnd) {
+      chunks.reserve(chunks.size() + 1);
+      void *chunk = Map(chunkSize, alignment);
+      if (chunk == nullptr)
+        return nullptr;
+      chunks.push_back(chunk);
+      cut = static_cast<char *>(chunk);
+      cutEnd = cut + chunkSize;
+    }
+    void *region = cut;
+    cut += numOfBytes;
+    return region;
+  }
+
+  /**
+   * Region deallocation function.
+   * @param[in] ptr pointer to region
+   * @param[in] numOfBytes region size given to allocation
+   */
+  void Free(void *ptr, size_t numOfBytes) {
+    auto region = mapped.find(ptr);
+    if (region != mapped.end()) {
+      Unmap(ptr, region->second);
+      mapped.erase(region);
+      return;
+    }
+    freeSlabs.push_back(ptr);
+  }
+
+  /**
+   * Take ownership of all regions of another source function.
+   * Pages of another node are moved to this node, sources with different huge pages usage are not compatible.
+   * Not used part of source last chunk is not reused.
+   * @param[in] source source to take regions from
+   * @return true if regions are taken, false if sources are not compatible or pages can not be moved
+   */
+  bool Absorb(numa_regions_t &source) {
+    if (source.hugePages != hugePages)
+      return false;
+    if (source.node != node) {
+      for (void *chunk : source.chunks)
+        if (!MovePages(chunk, chunkSize))
+          return false;
+      for (auto &region : source.mapped)
+        if (!MovePages(region.first, region.second))
+          return false;
+    }
+    chunks.insert(chunks.end(), source.chunks.begin(), source.chunks.end());
+    freeSlabs.insert(freeSlabs.end(), source.freeSlabs.begin(), source.freeSlabs.end());
+    mapped.insert(source.mapped.begin(), source.mapped.end());
+    source.chunks.clear();
+    source.freeSlabs.clear();
+    source.mapped.clear();
+    source.cut = nullptr;
+    source.cutEnd = nullptr;
+    return true;
+  }
+
+  /**
+   * Destructor.
+   */
+  ~numa_regions_t(void) {
+    for (void *chunk : chunks)
+      Unmap(chunk, chunkSize);
+    for (auto &region : mapped)
+      Unmap(region.first, region.second);
+  }
+};
+
+/**
+ * @brief NUMA allocation strategy class.
+ *
+ * Pool strategy with slabs bound to one NUMA node and optionally backed with huge pages.
+ * Deque can be migrated to another node with ChangeAllocator: if deque is the only owner of its NUMA strategy,
+ * pages are moved by system without copying (Linux only), otherwise elements are copied.
+ */
+class numa_strategy_t : public basic_pool_strategy_t<numa_regions_t> {
+public:
+  /**
+   * Constructor.
+   * @param[in] numaNode NUMA node to bind memory to
+   * @param[in] useHugePages use huge pages flag
+   */
+  explicit numa_strategy_t(int numaNode = 0, bool useHugePages = false) :
+    basic_pool_strategy_t<numa_regions_t>(numa_regions_t(numaNode, useHugePages)) {
+  }
+};
+
+#endif /* __NUMA_STRATEGY_H_INCLUDED */
@@ -0,0 +1,488 @@
+/**
+ * @file
+ * @brief Pool allocation strategy class header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains class of strategy that hands out fixed-size slots from large slabs
+ * and heap source of slab regions
+ */
+
+#pragma once
+
+#ifndef __POOL_STRATEGY_H_INCLUDED
+#define __POOL_STRATEGY_H_INCLUDED
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+#include "alloc_strategy.h"
+
+/**
+ * @brief Heap slab regions source class.
+ *
+ * Source of aligned regions for pool strategy slabs, takes regions from heap.
+ * Every regions source has Alloc, Free and Absorb functions with the same signatures.
+ */
+class heap_regions_t {
+public:
+  /**
+   * Aligned region allocation function.
+   * @param[in] numOfBytes region size, multiple of alignment
+   * @param[in] alignment region alignment
+   * @return pointer to allocated region, nullptr if there is no memory
+   */
+  void *Alloc(size_t numOfBytes, size_t alignment) {
+#ifdef _MSC_VER
+    return _aligned_malloc(numOfBytes, alignment);
+#else
+    return std::aligned_alloc(alignment, numOfBytes);
+#endif
+  }
+
+  /**
+   * Region deallocation function.
+   * @param[in] ptr pointer to region
+   * @param[in] numOfBytes region size given to allocation
+   */
+  void Free(void *ptr, size_t numOfBytes) {
+#ifdef _MSC_VER
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+  }
+
+  /**
+   * Take ownership of all regions of another source function.
+   * Heap regions need no bookkeeping.
+   * @param[in] source source to take regions from
+   * @return true
+   */
+  bool Absorb(heap_regions_t &source) {
+    return true;
+  }
+};
+
+/**
+ * @brief Pool allocation strategy class.
+ * @tparam Regions slab regions source type
+ *
+ * Strategy splits large aligned slabs into fixed-size slots of several size classes.
+ * Slab header lies at slab beginning, so slot owner is found by pointer masking and
+ * both allocation and deallocation are O(1).
+ * Blocks greater than maximal slot size get own aligned region with the same header.
+ * Slab header is padded to maximal native alignment, so blocks with alignment up to it
+ * are taken from slots of size class multiple of alignment without extra space.
+ * All slabs are linked into list to control leaks.
+ * Slab regions are taken from 'Regions' source (see 'heap_regions_t').
+ */
+template <typename Regions>
+class basic_pool_strategy_t : public alloc_strategy_t {
+public:
+  static constexpr size_t
+    slabSize = 256 * 1024,   ///< size and alignment of slab
+    maxSlotSize = 32 * 1024, ///< maximal size of block allocated from slots
+    maxAlignment = 64;       ///< maximal alignment of blocks given without extra space
+
+private:
+  static constexpr size_t
+    granularity = 16,                   ///< small size classes step
+    smallClasses = 1024 / granularity,  ///< number of small size classes
+    numOfClasses = smallClasses + 5;    ///< number of all size classes (up to 32K with power of 2 step)
+
+  /**
+   * @brief Slab header struct.
+   *
+   * Lies at the beginning of every slab and large block region.
+   */
+  struct slab_t {
+    slab_t
+      *prev,         ///< previous slab in list of all slabs
+      *next,         ///< next slab in list of all slabs
+      *prevPartial,  ///< previous slab with free slots of the same class
+      *nextPartial;  ///< next slab with free slots of the same class
+    size_t
+      sizeClass,     ///< slab size class, numOfClasses for large block
+      slotSize,      ///< size of one slot
+      liveSlots;     ///< number of allocated slots
+    void *freeSlots; ///< list of freed slots
+    char
+      *bump,         ///< beginning of never used slots
+      *end;          ///< slab end
+  };
+
+  static constexpr size_t headerSize = (sizeof(slab_t) + maxAlignment - 1) / maxAlignment * maxAlignment;  ///< slab header size with alignment
+
+  slab_t
+    *slabs,                  ///< list of all slabs
+    *partial[numOfClasses];  ///< lists of slabs with free slots by size class
+  Regions regions;           ///< slab regions source
+
+  /**
+   * Free slab region function.
+   * @param[in] slab slab to free
+   */
+  void FreeSlab(slab_t *slab) {
+    regions.Free(slab, slab->sizeClass == numOfClasses ? slab->slotSize + headerSize : slabSize);
+  }
+
+  /**
+   * Get size class by block size function.
+   * @param[in] numOfBytes block size
+   * @return size class index
+   */
+  static size_t SizeClass(size_t numOfBytes) {
+    if (numOfBytes <= smallClasses * granularity)
+      return numOfBytes == 0 ? 0 : (numOfBytes - 1) / granularity;
+    size_t sizeClass = smallClasses, slotSize = smallClasses * granularity * 2;
+    while (slotSize < numOfBytes) {
+      slotSize *= 2;
+      sizeClass++;
+    }
+    return sizeClass;
+  }
+
+  /**
+   * Get slot size by size class function.
+   * @param[in] sizeClass size class index
+   * @return slot size
+   */
+  static size_t SlotSize(size_t sizeClass) {
+    if (sizeClass < smallClasses)
+      return (sizeClass + 1) * granularity;
+    return smallClasses * granularity << (sizeClass - smallClasses + 1);
+  }
+
+  /**
+   * Get slab header of block function.
+   * @param[in] ptr pointer to block
+   * @return slab header
+   */
+  static slab_t *SlabOf(void *ptr) {
+    return reinterpret_cast<slab_t *>(reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t)(slabSize - 1));
+  }
+
+  /**
+   * Link slab to list of all slabs function.
+   * @param[in] slab slab to link
+   */
+  void LinkSlab(slab_t *slab) {
+    slab->prev = nullptr;
+    slab->next = slabs;
+    if (slabs != nullptr)
+      slabs->prev = slab;
+    slabs = slab;
+  }
+
+  /**
+   * Unlink slab from list of all slabs function.
+   * @param[in] slab slab to unlink
+   */
+  void UnlinkSlab(slab_t *slab) {
+    if (slab->prev != nullptr)
+      slab->prev->next = slab->next;
+    else
+      slabs = slab->next;
+    if (slab->next != nullptr)
+      slab->next->prev = slab->prev;
+  }
+
+  /**
+   * Link slab to list of slabs with free slots function.
+   * @param[in] slab slab to link
+   */
+  void LinkPartial(slab_t *slab) {
+    slab_t *&head = partial[slab->sizeClass];
+    slab->prevPartial = nullptr;
+    slab->nextPartial = head;
+    if (head != nullptr)
+      head->prevPartial = slab;
+    head = slab;
+  }
+
+  /**
+   * Unlink slab from list of slabs with free slots function.
+   * @param[in] slab slab to unlink
+   */
+  void UnlinkPartial(slab_t *slab) {
+    if (slab->prevPartial != nullptr)
+      slab->prevPartial->nextPartial = slab->nextPartial;
+    else
+      partial[slab->sizeClass] = slab->nextPartial;
+    if (slab->nextPartial != nullptr)
+      slab->nextPartial->prevPartial = slab->prevPartial;
+  }
+
+  /**
+   * Create empty slab of size class function.
+   * @param[in] sizeClass size class index
+   * @return created slab
+   */
+  slab_t *CreateSlab(size_t sizeClass) {
+    void *region = regions.Alloc(slabSize, slabSize);
+    if (region == nullptr)
+      throw std::bad_alloc();
+    slab_t *slab = static_cast<slab_t *>(region);
+    slab->sizeClass = sizeClass;
+    slab->slotSize = SlotSize(sizeClass);
+    slab->liveSlots = 0;
+    slab->freeSlots = nullptr;
+    slab->bump = static_cast<char *>(region) + headerSize;
+    slab->end = static_cast<char *>(region) + slabSize;
+    LinkSlab(slab);
+    LinkPartial(slab);
+    return slab;
+  }
+
+  /**
+   * Check slab has no free slots function.
+   * @param[in] slab slab to check
+   * @return true if slab is full, false - otherwise
+   */
+  static bool IsFull(slab_t const *slab) {
+    return slab->freeSlots == nullptr && slab->bump + slab->slotSize > slab->end;
+  }
+
+public:
+  /**
+   * Default constructor.
+   */
+  basic_pool_strategy_t(void) : slabs(nullptr) {
+    for (auto &head : partial)
+      head = nullptr;
+  }
+
+  /**
+   * Constructor by slab regions source.
+   * @param[in] newRegions slab regions source
+   */
+  explicit basic_pool_strategy_t(Regions &&newRegions) : slabs(nullptr), regions(std::move(newRegions)) {
+    for (auto &head : partial)
+      head = nullptr;
+  }
+
+  /**
+   * Deleted copy constructor.
+   */
+  basic_pool_strategy_t(basic_pool_strategy_t const &) = delete;
+
+  /**
+   * Deleted copy operator=.
+   */
+  basic_pool_strategy_t &operator=(basic_pool_strategy_t const &) = delete;
+
+  /**
+   * Allocation with memory block size function.
+   * @param[in] numOfBytes number of bytes to push
+   * @return pointer to allocated memory
+   */
+  void *alloc(size_t numOfBytes) override final {
+    if (numOfBytes > maxSlotSize) {
+      size_t regionSize = (headerSize + numOfBytes + slabSize - 1) / slabSize * slabSize;
+      void *region = regions.Alloc(regionSize, slabSize);
+      if (region == nullptr)
+        throw std::bad_alloc();
+      slab_t *slab = static_cast<slab_t *>(region);
+      slab->sizeClass = numOfClasses;
+      slab->slotSize = regionSize - headerSize;
+      slab->liveSlots = 1;
+      LinkSlab(slab);
+      return static_cast<char *>(region) + headerSize;
+    }
+    size_t sizeClass = SizeClass(numOfBytes);
+    slab_t *slab = partial[sizeClass];
+    if (slab == nullptr)
+      slab = CreateSlab(sizeClass);
+    void *slot;
+    if (slab->freeSlots != nullptr) {
+      slot = slab->freeSlots;
+      slab->freeSlots = *static_cast<void **>(slot);
+    }
+    else {
+      slot = slab->bump;
+      slab->bump += slab->slotSize;
+    }
+    slab->liveSlots++;
+    if (IsFull(slab))
+      UnlinkPartial(slab);
+    return slot;
+  }
+
+  /**
+   * Dealocation with pointer function.
+   * @param[in] ptr pointer to block
+   */
+  void dealloc(void *ptr) override final {
+    if (ptr == nullptr)
+      return;
+    slab_t *slab = SlabOf(ptr);
+    if (slab->sizeClass == numOfClasses) {
+      UnlinkSlab(slab);
+      FreeSlab(slab);
+      return;
+    }
+    bool wasFull = IsFull(slab);
+    *static_cast<void **>(ptr) = slab->freeSlots;
+    slab->freeSlots = ptr;
+    slab->liveSlots--;
+    if (wasFull)
+      LinkPartial(slab);
+    // keep one empty slab of class to avoid slab thrashing
+    if (slab->liveSlots == 0 && (slab->prevPartial != nullptr || slab->nextPartial != nullptr)) {
+      UnlinkPartial(slab);
+      UnlinkSlab(slab);
+      FreeSlab(slab);
+    }
+  }
+
+  /**
+   * Allocation of several memory blocks of one size function.
+   * @param[in] numOfBytes size of one block
+   * @param[in] count number of blocks
+   * @param[out] ptrs array to store pointers to allocated blocks
+   */
+  void alloc_n(size_t numOfBytes, size_t count, void **ptrs) override final {
+    size_t i = 0;
+    try {
+      for (; i < count; i++)
+        ptrs[i] = basic_pool_strategy_t::alloc(numOfBytes);
+    }
+    catch (...) {
+      basic_pool_strategy_t::dealloc_n(ptrs, i);
+      throw;
+    }
+  }
+
+  /**
+   * Dealocation of several blocks function.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   */
+  void dealloc_n(void **ptrs, size_t count) override final {
+    for (size_t i = 0; i < count; i++)
+      basic_pool_strategy_t::dealloc(ptrs[i]);
+  }
+
+  /**
+   * Dealocation with pointer and block size function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   */
+  void dealloc_sized(void *ptr, size_t numOfBytes) override final {
+    basic_pool_strategy_t::dealloc(ptr);
+  }
+
+  /**
+   * Dealocation of several blocks of one size function.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   * @param[in] numOfBytes size of one block given to allocation
+   */
+  void dealloc_n_sized(void **ptrs, size_t count, size_t numOfBytes) override final {
+    basic_pool_strategy_t::dealloc_n(ptrs, count);
+  }
+
+  /**
+   * Allocation with memory block size and alignment function.
+   * Size is rounded up to alignment, so block lies in slot aligned by slab header padding.
+   * Alignment greater than maximal native one is given by default implementation.
+   * @param[in] numOfBytes number of bytes to push
+   * @param[in] alignment power of 2 block alignment
+   * @return pointer to allocated memory
+   */
+  void *alloc_aligned(size_t numOfBytes, size_t alignment) override final {
+    if (alignment > maxAlignment)
+      return alloc_strategy_t::alloc_aligned(numOfBytes, alignment);
+    return basic_pool_strategy_t::alloc((numOfBytes + alignment - 1) & ~(alignment - 1));
+  }
+
+  /**
+   * Dealocation with pointer, block size and alignment function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   * @param[in] alignment block alignment given to allocation
+   */
+  void dealloc_aligned(void *ptr, size_t numOfBytes, size_t alignment) override final {
+    if (alignment > maxAlignment)
+      alloc_strategy_t::dealloc_aligned(ptr, numOfBytes, alignment);
+    else
+      basic_pool_strategy_t::dealloc(ptr);
+  }
+
+  /**
+   * Allocation of several memory blocks of one size and alignment function.
+   * @param[in] numOfBytes size of one block
+   * @param[in] alignment power of 2 block alignment
+   * @param[in] count number of blocks
+   * @param[out] ptrs array to store pointers to allocated blocks
+   */
+  void alloc_n_aligned(size_t numOfBytes, size_t alignment, size_t count, void **ptrs) override final {
+    if (alignment > maxAlignment)
+      alloc_strategy_t::alloc_n_aligned(numOfBytes, alignment, count, ptrs);
+    else
+      basic_pool_strategy_t::alloc_n((numOfBytes + alignment - 1) & ~(alignment - 1), count, ptrs);
+  }
+
+  /**
+   * Dealocation of several blocks of one size and alignment function.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   * @param[in] numOfBytes size of one block given to allocation
+   * @param[in] alignment blocks alignment given to allocation
+   */
+  void dealloc_n_aligned(void **ptrs, size_t count, size_t numOfBytes, size_t alignment) override final {
+    if (alignment > maxAlignment)
+      alloc_strategy_t::dealloc_n_aligned(ptrs, count, numOfBytes, alignment);
+    else
+      basic_pool_strategy_t::dealloc_n(ptrs, count);
+  }
+
+  /**
+   * Take ownership of all memory of another strategy function.
+   * Slabs of another pool strategy with the same regions source type are relinked to this pool lists
+   * if regions source absorbs their regions, other strategies are not compatible.
+   * @param[in] source strategy to take memory from
+   * @return true if memory is taken, false if strategies are not compatible
+   */
+  bool absorb(alloc_strategy_t &source) override final {
+    basic_pool_strategy_t *lhs = dynamic_cast<basic_pool_strategy_t *>(&source);
+    if (lhs == nullptr)
+      return false;
+    if (lhs == this)
+      return true;
+    if (!regions.Absorb(lhs->regions))
+      return false;
+    for (size_t i = 0; i < numOfClasses; i++)
+      while (lhs->partial[i] != nullptr) {
+        slab_t *slab = lhs->partial[i];
+        lhs->UnlinkPartial(slab);
+        LinkPartial(slab);
+      }
+    while (lhs->slabs != nullptr) {
+      slab_t *slab = lhs->slabs;
+      lhs->UnlinkSlab(slab);
+      LinkSlab(slab);
+    }
+    return true;
+  }
+
+  /**
+   * Destructor.
+   */
+  ~basic_pool_strategy_t(void) {
+    while (slabs != nullptr) {
+      slab_t *next = slabs->next;
+      FreeSlab(slabs);
+      slabs = next;
+    }
+  }
+};
+
+/**
+ * Pool allocation strategy with heap slab regions type.
+ */
+using pool_strategy_t = basic_pool_strategy_t<heap_regions_t>;
+
+#endif /* __POOL_STRATEGY_H_INCLUDED */
@@ -0,0 +1,327 @@
+/**
+ * @file
+ * @brief Standard library allocation adapters header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains adapters between allocation strategies, std::pmr::memory_resource and standard allocators
+ */
+
+#pragma once
+
+#ifndef __STD_ADAPTERS_H_INCLUDED
+#define __STD_ADAPTERS_H_INCLUDED
+
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+
+#include "allocator.h"
+
+/**
+ * @brief Memory resource allocation strategy class.
+ *
+ * Strategy takes blocks from std::pmr::memory_resource, so deques share memory with pmr containers.
+ * Resource is not owned and must outlive strategy and all its blocks.
+ * Memory resource needs block size to free it, so block deallocated without size is left to memory resource
+ * and is freed only with resource itself. Deques always deallocate blocks with size.
+ */
+class memory_resource_strategy_t : public alloc_strategy_t {
+private:
+  std::pmr::memory_resource *resource;  ///< memory resource to take blocks from
+
+public:
+  /**
+   * Constructor.
+   * @param[in] memoryResource memory resource, default resource if not given
+   */
+  explicit memory_resource_strategy_t(std::pmr::memory_resource *memoryResource = std::pmr::get_default_resource()) :
+    resource(memoryResource) {
+  }
+
+  /**
+   * Get memory resource function.
+   * @return pointer to memory resource
+   */
+  std::pmr::memory_resource *upstream(void) const {
+    return resource;
+  }
+
+  /**
+   * Allocation with memory block size function.
+   * @param[in] numOfBytes number of bytes to push
+   * @return pointer to allocated memory
+   */
+  void *alloc(size_t numOfBytes) override final {
+    return resource->allocate(numOfBytes, defaultAlignment);
+  }
+
+  /**
+   * Dealocation with pointer function. Block is left to memory resource, which needs block size to free it.
+   * @param[in] ptr pointer to block
+   */
+  void dealloc(void *ptr) override final {
+  }
+
+  /**
+   * Dealocation with pointer and block size function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   */
+  void dealloc_sized(void *ptr, size_t numOfBytes) override final {
+    if (ptr != nullptr)
+      resource->deallocate(ptr, numOfBytes, defaultAlignment);
+  }
+
+  /**
+   * Allocation of several memory blocks of one size function.
+   * @param[in] numOfBytes size of one block
+   * @param[in] count number of blocks
+   * @param[out] ptrs array to store pointers to allocated blocks
+   */
+  void alloc_n(size_t numOfBytes, size_t count, void **ptrs) override final {
+    memory_resource_strategy_t::alloc_n_aligned(numOfBytes, defaultAlignment, count, ptrs);
+  }
+
+  /**
+   * Dealocation of several blocks function. Blocks are left to memory resource, which needs block size to free them.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   */
+  void dealloc_n(void **ptrs, size_t count) override final {
+  }
+
+  /**
+   * Dealocation of several blocks of one size function.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   * @param[in] numOfBytes size of one block given to allocation
+   */
+  void dealloc_n_sized(void **ptrs, size_t count, size_t numOfBytes) override final {
+    memory_resource_strategy_t::dealloc_n_aligned(ptrs, count, numOfBytes, defaultAlignment);
+  }
+
+  /**
+   * Allocation with memory block size and alignment function.
+   * @param[in] numOfBytes number of bytes to push
+   * @param[in] alignment power of 2 block alignment
+   * @return pointer to allocated memory
+   */
+  void *alloc_aligned(size_t numOfBytes, size_t alignment) override final {
+    return resource->allocate(numOfBytes, std::max(alignment, defaultAlignment));
+  }
+
+  /**
+   * Dealocation with pointer, block size and alignment function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   * @param[in] alignment block alignment given to allocation
+   */
+  void dealloc_aligned(void *ptr, size_t numOfBytes, size_t alignment) override final {
+    if (ptr != nullptr)
+      resource->deallocate(ptr, numOfBytes, std::max(alignment, defaultAlignment));
+  }
+
+  /**
+   * Allocation of several memory blocks of one size and alignment function.
+   * @param[in] numOfBytes size of one block
+   * @param[in] alignment power of 2 block alignment
+   * @param[in] count number of blocks
+   * @param[out] ptrs array to store pointers to allocated blocks
+   */
+  void alloc_n_aligned(size_t numOfBytes, size_t alignment, size_t count, void **ptrs) override final {
+    size_t i = 0;
+    try {
+      for (; i < count; i++)
+        ptrs[i] = memory_resource_strategy_t::alloc_aligned(numOfBytes, alignment);
+    }
+    catch (...) {
+      memory_resource_strategy_t::dealloc_n_aligned(ptrs, i, numOfBytes, alignment);
+      throw;
+    }
+  }
+
+  /**
+   * Dealocation of several blocks of one size and alignment function.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   * @param[in] numOfBytes size of one block given to allocation
+   * @param[in] alignment blocks alignment given to allocation
+   */
+  void dealloc_n_aligned(void **ptrs, size_t count, size_t numOfBytes, size_t alignment) override final {
+    for (size_t i = 0; i < count; i++)
+      memory_resource_strategy_t::dealloc_aligned(ptrs[i], numOfBytes, alignment);
+  }
+
+  /**
+   * Take ownership of all memory of another strategy function.
+   * Blocks of another memory resource strategy are taken if its resource is equal to this one,
+   * other strategies are not compatible.
+   * @param[in] source strategy to take memory from
+   * @return true if memory is taken, false if strategies are not compatible
+   */
+  bool absorb(alloc_strategy_t &source) override final {
+    memory_resource_strategy_t *lhs = dynamic_cast<memory_resource_strategy_t *>(&source);
+    return lhs != nullptr && resource->is_equal(*lhs->resource);
+  }
+};
+
+/**
+ * @brief Allocation strategy memory resource class.
+ *
+ * std::pmr::memory_resource which takes blocks from shared allocation strategy,
+ * so pmr containers share memory with deques using the same strategy.
+ * Strategy is called without synchronization, so resource is used by one thread or with synchronized strategy.
+ */
+class strategy_resource_t : public std::pmr::memory_resource {
+private:
+  std::shared_ptr<alloc_strategy_t> strategy;  ///< allocation strategy to take blocks from
+
+public:
+  /**
+   * Constructor.
+   * @param[in] allocStrategy allocation strategy
+   */
+  explicit strategy_resource_t(std::shared_ptr<alloc_strategy_t> const &allocStrategy) : strategy(allocStrategy) {
+  }
+
+  /**
+   * Get allocation strategy function.
+   * @return shared pointer to strategy
+   */
+  std::shared_ptr<alloc_strategy_t> const &shared(void) const {
+    return strategy;
+  }
+
+private:
+  /**
+   * Allocation with memory block size and alignment function.
+   * @param[in] numOfBytes number of bytes to push
+   * @param[in] alignment power of 2 block alignment
+   * @return pointer to allocated memory
+   */
+  void *do_allocate(size_t numOfBytes, size_t alignment) override {
+    alloc_timer_t timer;
+    void *ptr = strategy->alloc_aligned(numOfBytes, alignment);
+    if constexpr (alloc_stats_t::isEnabled)
+      strategy->stats().OnAlloc(numOfBytes, 1, timer.Elapsed());
+    return ptr;
+  }
+
+  /**
+   * Dealocation with pointer, block size and alignment function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   * @param[in] alignment block alignment given to allocation
+   */
+  void do_deallocate(void *ptr, size_t numOfBytes, size_t alignment) override {
+    strategy->dealloc_aligned(ptr, numOfBytes, alignment);
+    if constexpr (alloc_stats_t::isEnabled)
+      strategy->stats().OnDealloc(numOfBytes, 1);
+  }
+
+  /**
+   * Resources equality function. Resources are equal if they use the same strategy instance.
+   * @param[in] lhs resource to compare
+   * @return true if memory allocated by one resource can be freed by another, false - otherwise
+   */
+  bool do_is_equal(std::pmr::memory_resource const &lhs) const noexcept override {
+    strategy_resource_t const *other = dynamic_cast<strategy_resource_t const *>(&lhs);
+    return other != nullptr && other->strategy == strategy;
+  }
+};
+
+/**
+ * @brief Standard allocator class.
+ * @tparam T type to allocate
+ * @tparam Strategy allocation strategy type, 'alloc_strategy_t' means runtime strategy
+ *
+ * Allocator satisfying standard Allocator requirements over 'single_allocator_t',
+ * so standard containers use the same strategies as deques.
+ */
+template <typename T, typename Strategy = alloc_strategy_t>
+class std_allocator_t {
+  template <typename U, typename S>
+  friend class std_allocator_t;
+
+private:
+  single_allocator_t<T, Strategy> allocator;  ///< allocator of arrays
+
+public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+  using is_always_equal = std::bool_constant<!strategy_holder_t<Strategy>::isDynamic>;
+
+  /**
+   * @brief Rebound allocator type struct.
+   * @tparam U another type to allocate
+   */
+  template <typename U>
+  struct rebind {
+    using other = std_allocator_t<U, Strategy>;
+  };
+
+  /**
+   * Default constructor. Available only for static strategy.
+   */
+  std_allocator_t(void) = default;
+
+  /**
+   * Constructor. Available only for runtime strategy.
+   * @param strategy allocation strategy
+   */
+  std_allocator_t(std::shared_ptr<alloc_strategy_t> const &strategy) : allocator(strategy) {
+  }
+
+  /**
+   * Constructor by allocator of another type. Uses the same strategy.
+   * @tparam U another allocator type
+   * @param[in] lhs allocator to take strategy from
+   */
+  template <typename U>
+  std_allocator_t(std_allocator_t<U, Strategy> const &lhs) : allocator(lhs.allocator) {
+  }
+
+  /**
+   * Allocation of memory for array without construction function.
+   * @param[in] count number of instances
+   * @return pointer to allocated array
+   */
+  T *allocate(size_t count) {
+    return allocator.allocArrayRaw(count);
+  }
+
+  /**
+   * Deallocation of array memory without destruction function.
+   * @param[in] ptr pointer to array
+   * @param[in] count number of instances given to allocation
+   */
+  void deallocate(T *ptr, size_t count) {
+    allocator.deallocArrayRaw(ptr, count);
+  }
+
+  /**
+   * Equality operator. Allocators are equal if they use the same strategy instance.
+   * @tparam U another allocator type
+   * @param[in] lhs allocator to compare
+   * @return true if allocators are equal, false - otherwise
+   */
+  template <typename U>
+  bool operator==(std_allocator_t<U, Strategy> const &lhs) const {
+    return allocator == single_allocator_t<T, Strategy>(lhs.allocator);
+  }
+
+  /**
+   * Inequality operator.
+   * @tparam U another allocator type
+   * @param[in] lhs allocator to compare
+   * @return true if allocators use different strategies, false - otherwise
+   */
+  template <typename U>
+  bool operator!=(std_allocator_t<U, Strategy> const &lhs) const {
+    return !(*this == lhs);
+  }
+};
+
+#endif /* __STD_ADAPTERS_H_INCLUDED */
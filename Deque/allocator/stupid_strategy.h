@@ -49,6 +49,30 @@ public:
     }
   }
 
+  /**
+   * Dealocation with pointer and block size function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   */
+  void dealloc_sized(void *ptr, size_t numOfBytes) override final {
+    stupid_strategy_t::dealloc(ptr);
+  }
+
+  /**
+   * Take ownership of all memory of another strategy function.
+   * Blocks list of very stupid strategy is spliced, other strategies are not compatible.
+   * @param[in] source strategy to take memory from
+   * @return true if memory is taken, false if strategies are not compatible
+   */
+  bool absorb(alloc_strategy_t &source) override final {
+    stupid_strategy_t *lhs = dynamic_cast<stupid_strategy_t *>(&source);
+    if (lhs == nullptr)
+      return false;
+    if (lhs != this)
+      allocEls.splice(allocEls.end(), lhs->allocEls);
+    return true;
+  }
+
   /**
    * Destructor.
    */
@@ -0,0 +1,183 @@
+/**
+ * @file
+ * @brief Synchronized allocation strategy class header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains class of strategy decorator that makes any strategy safe for concurrent calls
+ */
+
+#pragma once
+
+#ifndef __SYNCHRONIZED_STRATEGY_H_INCLUDED
+#define __SYNCHRONIZED_STRATEGY_H_INCLUDED
+
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+#include "alloc_strategy.h"
+
+/**
+ * @brief Synchronized allocation strategy class.
+ * @tparam Backing backing strategy type, 'alloc_strategy_t' means shared runtime strategy
+ *
+ * Strategy serializes all calls to backing strategy with mutex.
+ * With runtime backing strategy it holds shared strategy given to constructor,
+ * with any other backing type it owns backing strategy and is default constructible,
+ * so it can be used as static strategy.
+ */
+template <typename Backing = alloc_strategy_t>
+class synchronized_strategy_t : public alloc_strategy_t {
+public:
+  static constexpr bool isThreadSafe = true;  ///< strategy can be called concurrently flag
+
+private:
+  using backing_t = typename std::conditional<std::is_same<Backing, alloc_strategy_t>::value,
+    std::shared_ptr<alloc_strategy_t>, Backing>::type;  ///< backing strategy storage type
+
+  backing_t backing;  ///< backing strategy
+  std::mutex mutex;   ///< backing strategy calls mutex
+
+  /**
+   * Get shared backing strategy function.
+   * @param[in] strategy backing strategy storage
+   * @return reference to strategy
+   */
+  static alloc_strategy_t &Get(std::shared_ptr<alloc_strategy_t> &strategy) {
+    return *strategy;
+  }
+
+  /**
+   * Get owned backing strategy function.
+   * @param[in] strategy backing strategy storage
+   * @return reference to strategy
+   */
+  template <typename S>
+  static S &Get(S &strategy) {
+    return strategy;
+  }
+
+public:
+  /**
+   * Default constructor. Available only for owned backing strategy.
+   */
+  synchronized_strategy_t(void) {
+    static_assert(!std::is_same<Backing, alloc_strategy_t>::value, "Runtime backing strategy is needed to construct");
+  }
+
+  /**
+   * Constructor by shared backing strategy. Available only for runtime backing strategy.
+   * @param[in] strategy backing strategy
+   */
+  explicit synchronized_strategy_t(std::shared_ptr<alloc_strategy_t> const &strategy) : backing(strategy) {
+  }
+
+  /**
+   * Allocation with memory block size function.
+   * @param[in] numOfBytes number of bytes to push
+   * @return pointer to allocated memory
+   */
+  void *alloc(size_t numOfBytes) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Get(backing).alloc(numOfBytes);
+  }
+
+  /**
+   * Dealocation with pointer function.
+   * @param[in] ptr pointer to block
+   */
+  void dealloc(void *ptr) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).dealloc(ptr);
+  }
+
+  /**
+   * Dealocation with pointer and block size function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   */
+  void dealloc_sized(void *ptr, size_t numOfBytes) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).dealloc_sized(ptr, numOfBytes);
+  }
+
+  /**
+   * Allocation of several memory blocks of one size function.
+   * @param[in] numOfBytes size of one block
+   * @param[in] count number of blocks
+   * @param[out] ptrs array to store pointers to allocated blocks
+   */
+  void alloc_n(size_t numOfBytes, size_t count, void **ptrs) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).alloc_n(numOfBytes, count, ptrs);
+  }
+
+  /**
+   * Dealocation of several blocks function.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   */
+  void dealloc_n(void **ptrs, size_t count) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).dealloc_n(ptrs, count);
+  }
+
+  /**
+   * Dealocation of several blocks of one size function.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   * @param[in] numOfBytes size of one block given to allocation
+   */
+  void dealloc_n_sized(void **ptrs, size_t count, size_t numOfBytes) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).dealloc_n_sized(ptrs, count, numOfBytes);
+  }
+
+  /**
+   * Allocation with memory block size and alignment function.
+   * @param[in] numOfBytes number of bytes to push
+   * @param[in] alignment power of 2 block alignment
+   * @return pointer to allocated memory
+   */
+  void *alloc_aligned(size_t numOfBytes, size_t alignment) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Get(backing).alloc_aligned(numOfBytes, alignment);
+  }
+
+  /**
+   * Dealocation with pointer, block size and alignment function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   * @param[in] alignment block alignment given to allocation
+   */
+  void dealloc_aligned(void *ptr, size_t numOfBytes, size_t alignment) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).dealloc_aligned(ptr, numOfBytes, alignment);
+  }
+
+  /**
+   * Allocation of several memory blocks of one size and alignment function.
+   * @param[in] numOfBytes size of one block
+   * @param[in] alignment power of 2 block alignment
+   * @param[in] count number of blocks
+   * @param[out] ptrs array to store pointers to allocated blocks
+   */
+  void alloc_n_aligned(size_t numOfBytes, size_t alignment, size_t count, void **ptrs) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).alloc_n_aligned(numOfBytes, alignment, count, ptrs);
+  }
+
+  /**
+   * Dealocation of several blocks of one size and alignment function.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   * @param[in] numOfBytes size of one block given to allocation
+   * @param[in] alignment blocks alignment given to allocation
+   */
+  void dealloc_n_aligned(void **ptrs, size_t count, size_t numOfBytes, size_t alignment) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).dealloc_n_aligned(ptrs, count, numOfBytes, alignment);
+  }
+};
+
+#endif /* __SYNCHRONIZED_STRATEGY_H_INCLUDED */
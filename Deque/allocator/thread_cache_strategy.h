@@ -0,0 +1,355 @@
+/**
+ * @file
+ * @brief Thread cache allocation strategy class header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains class of strategy decorator that caches freed blocks in per thread magazines
+ */
+
+#pragma once
+
+#ifndef __THREAD_CACHE_STRATEGY_H_INCLUDED
+#define __THREAD_CACHE_STRATEGY_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "alloc_strategy.h"
+
+/**
+ * @brief Thread cache allocation strategy class.
+ * @tparam Backing backing strategy type, 'alloc_strategy_t' means shared runtime strategy
+ *
+ * Strategy keeps magazines of free blocks of several size classes for every thread.
+ * Allocation and sized deallocation use calling thread magazine without locks,
+ * empty magazine is refilled and full magazine is flushed with one batch call to backing strategy under mutex.
+ * Blocks greater than maximal cached size and unsized deallocations go to backing strategy directly.
+ * Magazines of all threads are returned to backing strategy on destruction.
+ * With runtime backing strategy it holds shared strategy given to constructor,
+ * with any other backing type it owns backing strategy and is default constructible,
+ * so it can be used as static strategy.
+ */
+template <typename Backing = alloc_strategy_t>
+class thread_cache_strategy_t : public alloc_strategy_t {
+public:
+  static constexpr bool isThreadSafe = true;     ///< strategy can be called concurrently flag
+  static constexpr size_t maxCachedSize = 1024;  ///< maximal size of block cached in magazines
+
+private:
+  using backing_t = typename std::conditional<std::is_same<Backing, alloc_strategy_t>::value,
+    std::shared_ptr<alloc_strategy_t>, Backing>::type;  ///< backing strategy storage type
+
+  static constexpr size_t
+    granularity = 16,                             ///< size classes step
+    numOfClasses = maxCachedSize / granularity,   ///< number of size classes
+    magazineSize = 32,                            ///< maximal number of blocks in magazine
+    transferBatch = magazineSize / 2;             ///< number of blocks taken from or given to backing strategy at once
+
+  /**
+   * @brief Magazine struct.
+   *
+   * Stack of free blocks of one size class.
+   */
+  struct magazine_t {
+    size_t count = 0;            ///< number of blocks
+    void *slots[magazineSize];   ///< free blocks
+  };
+
+  /**
+   * @brief Thread cache struct.
+   *
+   * Magazines of one thread for all size classes.
+   */
+  struct cache_t {
+    magazine_t magazines[numOfClasses];  ///< magazines by size class
+  };
+
+  /**
+   * @brief Thread local caches index struct.
+   *
+   * Maps strategy instance identifiers to calling thread caches, last used cache is checked first.
+   * Caches are owned by strategies, so entries of destroyed strategies expire and are removed on next registration.
+   */
+  struct local_index_t {
+    uint64_t lastOwner = 0;                                      ///< identifier of last used strategy instance
+    cache_t *lastCache = nullptr;                                ///< last used cache
+    std::unordered_map<uint64_t, std::weak_ptr<cache_t>> caches;  ///< caches by strategy instance identifier
+  };
+
+  backing_t backing;                            ///< backing strategy
+  std::mutex mutex;                             ///< backing strategy calls and caches list mutex
+  std::vector<std::shared_ptr<cache_t>> caches; ///< caches of all threads
+  uint64_t const id;                            ///< unique strategy instance identifier
+
+  /**
+   * Get shared backing strategy function.
+   * @param[in] strategy backing strategy storage
+   * @return reference to strategy
+   */
+  static alloc_strategy_t &Get(std::shared_ptr<alloc_strategy_t> &strategy) {
+    return *strategy;
+  }
+
+  /**
+   * Get owned backing strategy function.
+   * @param[in] strategy backing strategy storage
+   * @return reference to strategy
+   */
+  template <typename S>
+  static S &Get(S &strategy) {
+    return strategy;
+  }
+
+  /**
+   * Generate unique strategy instance identifier function.
+   * @return identifier, never 0
+   */
+  static uint64_t NextId(void) {
+    static std::atomic<uint64_t> lastId(0);
+    return lastId.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+
+  /**
+   * Get size class by block size function.
+   * @param[in] numOfBytes block size, not greater than maximal cached size
+   * @return size class index
+   */
+  static size_t SizeClass(size_t numOfBytes) {
+    return numOfBytes == 0 ? 0 : (numOfBytes - 1) / granularity;
+  }
+
+  /**
+   * Get block size by size class function.
+   * @param[in] sizeClass size class index
+   * @return block size
+   */
+  static size_t SlotSize(size_t sizeClass) {
+    return (sizeClass + 1) * granularity;
+  }
+
+  /**
+   * Get calling thread cache function.
+   * Cache is created and registered on first call from thread, expired entries of thread index are removed then.
+   * @return reference to cache
+   */
+  cache_t &LocalCache(void) {
+    static thread_local local_index_t index;
+    if (index.lastOwner == id)
+      return *index.lastCache;
+    auto found = index.caches.find(id);
+    cache_t *cache;
+    if (found != index.caches.end())
+      cache = found->second.lock().get();
+    else {
+      for (auto entry = index.caches.begin(); entry != index.caches.end();)
+        if (entry->second.expired())
+          entry = index.caches.erase(entry);
+        else
+          ++entry;
+      std::shared_ptr<cache_t> created = std::make_shared<cache_t>();
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        caches.push_back(created);
+      }
+      index.caches.emplace(id, created);
+      cache = created.get();
+    }
+    index.lastOwner = id;
+    index.lastCache = cache;
+    return *cache;
+  }
+
+public:
+  /**
+   * Default constructor. Available only for owned backing strategy.
+   */
+  thread_cache_strategy_t(void) : id(NextId()) {
+    static_assert(!std::is_same<Backing, alloc_strategy_t>::value, "Runtime backing strategy is needed to construct");
+  }
+
+  /**
+   * Constructor by shared backing strategy. Available only for runtime backing strategy.
+   * @param[in] strategy backing strategy
+   */
+  explicit thread_cache_strategy_t(std::shared_ptr<alloc_strategy_t> const &strategy) :
+    backing(strategy), id(NextId()) {
+  }
+
+  /**
+   * Deleted copy constructor.
+   */
+  thread_cache_strategy_t(thread_cache_strategy_t const &) = delete;
+
+  /**
+   * Deleted copy operator=.
+   */
+  thread_cache_strategy_t &operator=(thread_cache_strategy_t const &) = delete;
+
+  /**
+   * Allocation with memory block size function.
+   * @param[in] numOfBytes number of bytes to push
+   * @return pointer to allocated memory
+   */
+  void *alloc(size_t numOfBytes) override final {
+    if (numOfBytes > maxCachedSize) {
+      std::lock_guard<std::mutex> lock(mutex);
+      return Get(backing).alloc(numOfBytes);
+    }
+    size_t sizeClass = SizeClass(numOfBytes);
+    magazine_t &magazine = LocalCache().magazines[sizeClass];
+    if (magazine.count == 0) {
+      std::lock_guard<std::mutex> lock(mutex);
+      Get(backing).alloc_n(SlotSize(sizeClass), transferBatch, magazine.slots);
+      magazine.count = transferBatch;
+    }
+    return magazine.slots[--magazine.count];
+  }
+
+  /**
+   * Dealocation with pointer function. Block is returned to backing strategy directly.
+   * @param[in] ptr pointer to block
+   */
+  void dealloc(void *ptr) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).dealloc(ptr);
+  }
+
+  /**
+   * Dealocation with pointer and block size function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   */
+  void dealloc_sized(void *ptr, size_t numOfBytes) override final {
+    if (ptr == nullptr)
+      return;
+    if (numOfBytes > maxCachedSize) {
+      std::lock_guard<std::mutex> lock(mutex);
+      Get(backing).dealloc_sized(ptr, numOfBytes);
+      return;
+    }
+    size_t sizeClass = SizeClass(numOfBytes);
+    magazine_t &magazine = LocalCache().magazines[sizeClass];
+    if (magazine.count == magazineSize) {
+      std::lock_guard<std::mutex> lock(mutex);
+      Get(backing).dealloc_n_sized(magazine.slots + magazineSize - transferBatch, transferBatch, SlotSize(sizeClass));
+      magazine.count -= transferBatch;
+    }
+    magazine.slots[magazine.count++] = ptr;
+  }
+
+  /**
+   * Allocation of several memory blocks of one size function.
+   * @param[in] numOfBytes size of one block
+   * @param[in] count number of blocks
+   * @param[out] ptrs array to store pointers to allocated blocks
+   */
+  void alloc_n(size_t numOfBytes, size_t count, void **ptrs) override final {
+    size_t i = 0;
+    try {
+      for (; i < count; i++)
+        ptrs[i] = thread_cache_strategy_t::alloc(numOfBytes);
+    }
+    catch (...) {
+      thread_cache_strategy_t::dealloc_n_sized(ptrs, i, numOfBytes);
+      throw;
+    }
+  }
+
+  /**
+   * Dealocation of several blocks function. Blocks are returned to backing strategy directly.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   */
+  void dealloc_n(void **ptrs, size_t count) override final {
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).dealloc_n(ptrs, count);
+  }
+
+  /**
+   * Dealocation of several blocks of one size function.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   * @param[in] numOfBytes size of one block given to allocation
+   */
+  void dealloc_n_sized(void **ptrs, size_t count, size_t numOfBytes) override final {
+    for (size_t i = 0; i < count; i++)
+      thread_cache_strategy_t::dealloc_sized(ptrs[i], numOfBytes);
+  }
+
+  /**
+   * Allocation with memory block size and alignment function.
+   * Aligned blocks are not cached and are taken from backing strategy directly.
+   * @param[in] numOfBytes number of bytes to push
+   * @param[in] alignment power of 2 block alignment
+   * @return pointer to allocated memory
+   */
+  void *alloc_aligned(size_t numOfBytes, size_t alignment) override final {
+    if (alignment <= defaultAlignment)
+      return thread_cache_strategy_t::alloc(numOfBytes);
+    std::lock_guard<std::mutex> lock(mutex);
+    return Get(backing).alloc_aligned(numOfBytes, alignment);
+  }
+
+  /**
+   * Dealocation with pointer, block size and alignment function.
+   * @param[in] ptr pointer to block
+   * @param[in] numOfBytes block size given to allocation
+   * @param[in] alignment block alignment given to allocation
+   */
+  void dealloc_aligned(void *ptr, size_t numOfBytes, size_t alignment) override final {
+    if (alignment <= defaultAlignment) {
+      thread_cache_strategy_t::dealloc_sized(ptr, numOfBytes);
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).dealloc_aligned(ptr, numOfBytes, alignment);
+  }
+
+  /**
+   * Allocation of several memory blocks of one size and alignment function.
+   * @param[in] numOfBytes size of one block
+   * @param[in] alignment power of 2 block alignment
+   * @param[in] count number of blocks
+   * @param[out] ptrs array to store pointers to allocated blocks
+   */
+  void alloc_n_aligned(size_t numOfBytes, size_t alignment, size_t count, void **ptrs) override final {
+    if (alignment <= defaultAlignment) {
+      thread_cache_strategy_t::alloc_n(numOfBytes, count, ptrs);
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).alloc_n_aligned(numOfBytes, alignment, count, ptrs);
+  }
+
+  /**
+   * Dealocation of several blocks of one size and alignment function.
+   * @param[in] ptrs array of pointers to blocks
+   * @param[in] count number of blocks
+   * @param[in] numOfBytes size of one block given to allocation
+   * @param[in] alignment blocks alignment given to allocation
+   */
+  void dealloc_n_aligned(void **ptrs, size_t count, size_t numOfBytes, size_t alignment) override final {
+    if (alignment <= defaultAlignment) {
+      thread_cache_strategy_t::dealloc_n_sized(ptrs, count, numOfBytes);
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    Get(backing).dealloc_n_aligned(ptrs, count, numOfBytes, alignment);
+  }
+
+  /**
+   * Destructor. Strategy must not be used by other threads during destruction.
+   */
+  ~thread_cache_strategy_t(void) {
+    for (auto &cache : caches)
+      for (size_t i = 0; i < numOfClasses; i++)
+        Get(backing).dealloc_n_sized(cache->magazines[i].slots, cache->magazines[i].count, SlotSize(i));
+  }
+};
+
+#endif /* __THREAD_CACHE_STRATEGY_H_INCLUDED */
@@ -0,0 +1,509 @@
+/**
+ * @file
+ * @brief Deque benchmark source file
+ * @authors Vorotnikov Andrey
+ *
+ * Measures deque operations with all allocation strategies against std::deque and std::list
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "../deque/deque.h"
+#include "../deque/chunked_deque.h"
+#include "../allocator/stupid_strategy.h"
+#include "../allocator/pool_strategy.h"
+#include "../allocator/arena_strategy.h"
+#include "../allocator/synchronized_strategy.h"
+#include "../allocator/numa_strategy.h"
+#include "../allocator/thread_cache_strategy.h"
+
+/**
+ * @brief Benchmark options struct.
+ */
+struct options_t {
+  size_t
+    maxElements = 10000000,        ///< maximal number of elements in one container
+    targetElements = 1000000,      ///< number of elements in all containers of one measurement
+    maxContainers = 1000,          ///< maximal number of containers of one measurement, every one may own strategy chunks
+    maxBytes = 1024 * 1024 * 1024, ///< maximal size of elements of one measurement
+    maxStupidElements = 10000;     ///< maximal number of elements in container with very stupid strategy (O(n) deallocation)
+};
+
+/**
+ * @brief Benchmark element struct.
+ * @tparam Size element size
+ */
+template <size_t Size>
+struct payload_t {
+  unsigned char data[Size];  ///< element data
+
+  /**
+   * Constructor by value.
+   * @param[in] value value to store in first byte
+   */
+  payload_t(int value) {
+    std::memset(data, 0, Size);
+    data[0] = static_cast<unsigned char>(value);
+  }
+};
+
+static volatile size_t sink;  ///< checksum sink to keep measured code
+
+/**
+ * Get element value function.
+ * @param[in] element element
+ * @return element value
+ */
+inline size_t Value(int element) {
+  return static_cast<size_t>(element);
+}
+
+/**
+ * Get element value function.
+ * @tparam Size element size
+ * @param[in] element element
+ * @return element value
+ */
+template <size_t Size>
+size_t Value(payload_t<Size> const &element) {
+  return element.data[0];
+}
+
+/**
+ * Push element back to library deque function.
+ * @tparam C container type
+ * @tparam V element type
+ * @param[in] container container
+ * @param[in] value element
+ */
+template <typename C, typename V>
+void PushBack(C &container, V &&value) {
+  container.PushBack(std::forward<V>(value));
+}
+
+/**
+ * Push element back to std::deque function.
+ * @tparam T elements type
+ * @tparam V element type
+ * @param[in] container container
+ * @param[in] value element
+ */
+template <typename T, typename V>
+void PushBack(std::deque<T> &container, V &&value) {
+  container.push_back(std::forward<V>(value));
+}
+
+/**
+ * Push element back to std::list function.
+ * @tparam T elements type
+ * @tparam V element type
+ * @param[in] container container
+ * @param[in] value element
+ */
+template <typename T, typename V>
+void PushBack(std::list<T> &container, V &&value) {
+  container.push_back(std::forward<V>(value));
+}
+
+/**
+ * Push element front to library deque function.
+ * @tparam C container type
+ * @tparam V element type
+ * @param[in] container container
+ * @param[in] value element
+ */
+template <typename C, typename V>
+void PushFront(C &container, V &&value) {
+  container.PushFront(std::forward<V>(value));
+}
+
+/**
+ * Push element front to std::deque function.
+ * @tparam T elements type
+ * @tparam V element type
+ * @param[in] container container
+ * @param[in] value element
+ */
+template <typename T, typename V>
+void PushFront(std::deque<T> &container, V &&value) {
+  container.push_front(std::forward<V>(value));
+}
+
+/**
+ * Push element front to std::list function.
+ * @tparam T elements type
+ * @tparam V element type
+ * @param[in] container container
+ * @param[in] value element
+ */
+template <typename T, typename V>
+void PushFront(std::list<T> &container, V &&value) {
+  container.push_front(std::forward<V>(value));
+}
+
+/**
+ * Pop element back from library deque function.
+ * @tparam C container type
+ * @param[in] container container
+ * @return element value
+ */
+template <typename C>
+size_t PopBack(C &container) {
+  return Value(container.PopBack());
+}
+
+/**
+ * Pop element back from std::deque function.
+ * @tparam T elements type
+ * @param[in] container container
+ * @return element value
+ */
+template <typename T>
+size_t PopBack(std::deque<T> &container) {
+  size_t value = Value(container.back());
+  container.pop_back();
+  return value;
+}
+
+/**
+ * Pop element back from std::list function.
+ * @tparam T elements type
+ * @param[in] container container
+ * @return element value
+ */
+template <typename T>
+size_t PopBack(std::list<T> &container) {
+  size_t value = Value(container.back());
+  container.pop_back();
+  return value;
+}
+
+/**
+ * Pop element front from library deque function.
+ * @tparam C container type
+ * @param[in] container container
+ * @return element value
+ */
+template <typename C>
+size_t PopFront(C &container) {
+  return Value(container.PopFront());
+}
+
+/**
+ * Pop element front from std::deque function.
+ * @tparam T elements type
+ * @param[in] container container
+ * @return element value
+ */
+template <typename T>
+size_t PopFront(std::deque<T> &container) {
+  size_t value = Value(container.front());
+  container.pop_front();
+  return value;
+}
+
+/**
+ * Pop element front from std::list function.
+ * @tparam T elements type
+ * @param[in] container container
+ * @return element value
+ */
+template <typename T>
+size_t PopFront(std::list<T> &container) {
+  size_t value = Value(container.front());
+  container.pop_front();
+  return value;
+}
+
+/**
+ * Sum library deque elements by contiguous spans function.
+ * @tparam C container type
+ * @param[in] container container
+ * @return sum of element values
+ */
+template <typename C>
+size_t SumBlocks(C &container) {
+  size_t sum = 0;
+  container.ForEachBlock([&sum](auto *data, size_t count) {
+    for (size_t i = 0; i < count; i++)
+      sum += Value(data[i]);
+  });
+  return sum;
+}
+
+/**
+ * Sum std::deque elements function.
+ * @tparam T elements type
+ * @param[in] container container
+ * @return sum of element values
+ */
+template <typename T>
+size_t SumBlocks(std::deque<T> &container) {
+  size_t sum = 0;
+  for (auto &element : container)
+    sum += Value(element);
+  return sum;
+}
+
+/**
+ * Sum std::list elements function.
+ * @tparam T elements type
+ * @param[in] container container
+ * @return sum of element values
+ */
+template <typename T>
+size_t SumBlocks(std::list<T> &container) {
+  size_t sum = 0;
+  for (auto &element : container)
+    sum += Value(element);
+  return sum;
+}
+
+/**
+ * @brief Measurement timer class.
+ */
+class bench_timer_t {
+private:
+  std::chrono::steady_clock::time_point start;  ///< start time
+
+public:
+  /**
+   * Constructor. Starts timer.
+   */
+  bench_timer_t(void) : start(std::chrono::steady_clock::now()) {
+  }
+
+  /**
+   * Get elapsed time function.
+   * @return number of nanoseconds from start
+   */
+  double Elapsed(void) const {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  }
+};
+
+/**
+ * Print measurement result function.
+ * @param[in] container container name
+ * @param[in] elementSize element size
+ * @param[in] count number of elements in one container
+ * @param[in] operation operation name
+ * @param[in] nanoseconds measured time
+ * @param[in] operations number of measured element operations
+ */
+static void Report(char const *container, size_t elementSize, size_t count, char const *operation,
+  double nanoseconds, size_t operations) {
+  std::printf("%-24s %6zu %9zu %-14s %10.2f ns/elem\n", container, elementSize, count, operation, nanoseconds / operations);
+}
+
+/**
+ * Run all measurements for one container type and size function.
+ * @tparam T elements type
+ * @tparam Factory container factory type
+ * @tparam Migrate container strategy change function type
+ * @param[in] name container name
+ * @param[in] count number of elements in one container
+ * @param[in] options benchmark options
+ * @param[in] make container factory
+ * @param[in] migrate container strategy change function, returns false if container has no strategy
+ */
+template <typename T, typename Factory, typename Migrate>
+void RunCase(char const *name, size_t count, options_t const &options, Factory make, Migrate migrate) {
+  using container_t = decltype(make());
+  size_t
+    numOfContainers = std::clamp<size_t>(options.targetElements / count, 1, options.maxContainers),
+    operations = numOfContainers * count,
+    checksum = 0;
+  std::vector<container_t> containers;
+  containers.reserve(numOfContainers);
+  for (size_t i = 0; i < numOfContainers; i++)
+    containers.push_back(make());
+
+  auto fill = [&](void) {
+    for (auto &container : containers)
+      for (size_t i = 0; i < count; i++)
+        PushBack(container, T(static_cast<int>(i)));
+  };
+
+  {
+    bench_timer_t timer;
+    fill();
+    Report(name, sizeof(T), count, "push_back", timer.Elapsed(), operations);
+  }
+  {
+    bench_timer_t timer;
+    for (auto &container : containers)
+      for (auto &element : container)
+        checksum += Value(element);
+    Report(name, sizeof(T), count, "iterate", timer.Elapsed(), operations);
+  }
+  {
+    bench_timer_t timer;
+    for (auto &container : containers)
+      checksum += SumBlocks(container);
+    Report(name, sizeof(T), count, "sum_blocks", timer.Elapsed(), operations);
+  }
+  {
+    std::vector<container_t> copies;
+    copies.reserve(numOfContainers);
+    bench_timer_t timer;
+    for (auto &container : containers)
+      copies.push_back(container_t(container));
+    Report(name, sizeof(T), count, "copy", timer.Elapsed(), operations);
+  }
+  {
+    bench_timer_t timer;
+    for (auto &container : containers)
+      for (size_t i = 0; i < count; i++)
+        checksum += PopFront(container);
+    Report(name, sizeof(T), count, "pop_front", timer.Elapsed(), operations);
+  }
+  {
+    bench_timer_t timer;
+    for (auto &container : containers)
+      for (size_t i = 0; i < count; i++)
+        PushFront(container, T(static_cast<int>(i)));
+    Report(name, sizeof(T), count, "push_front", timer.Elapsed(), operations);
+  }
+  {
+    bench_timer_t timer;
+    for (auto &container : containers)
+      for (size_t i = 0; i < count; i++)
+        checksum += PopBack(container);
+    Report(name, sizeof(T), count, "pop_back", timer.Elapsed(), operations);
+  }
+  {
+    // queue of count / 2 elements: every push back is followed by pop front
+    bench_timer_t timer;
+    for (auto &container : containers) {
+      for (size_t i = 0; i < count / 2; i++)
+        PushBack(container, T(static_cast<int>(i)));
+      for (size_t i = 0; i < count; i++) {
+        PushBack(container, T(static_cast<int>(i)));
+        checksum += PopFront(container);
+      }
+      for (size_t i = 0; i < count / 2; i++)
+        checksum += PopFront(container);
+    }
+    Report(name, sizeof(T), count, "fifo", timer.Elapsed(), operations * 2);
+  }
+  {
+    // stack of count / 2 elements: pushes and pops at back by pairs
+    bench_timer_t timer;
+    for (auto &container : containers) {
+      for (size_t i = 0; i < count / 2; i++)
+        PushBack(container, T(static_cast<int>(i)));
+      for (size_t i = 0; i < count / 2; i++) {
+        PushBack(container, T(static_cast<int>(i)));
+        PushBack(container, T(static_cast<int>(i)));
+        checksum += PopBack(container);
+        checksum += PopBack(container);
+      }
+      for (size_t i = 0; i < count / 2; i++)
+        checksum += PopBack(container);
+    }
+    Report(name, sizeof(T), count, "lifo", timer.Elapsed(), operations * 2);
+  }
+  fill();
+  {
+    bench_timer_t timer;
+    bool isMigrated = true;
+    for (auto &container : containers)
+      isMigrated = migrate(container) && isMigrated;
+    if (isMigrated)
+      Report(name, sizeof(T), count, "change_alloc", timer.Elapsed(), operations);
+  }
+  {
+    bench_timer_t timer;
+    containers.clear();
+    Report(name, sizeof(T), count, "teardown", timer.Elapsed(), operations);
+  }
+  sink = sink + checksum;
+}
+
+/**
+ * Run all measurements for one elements type function.
+ * @tparam T elements type
+ * @param[in] options benchmark options
+ */
+template <typename T>
+void RunElement(options_t const &options) {
+  auto noMigrate = [](auto &) {
+    return false;
+  };
+  auto poolMigrate = [](auto &container) {
+    container.ChangeAllocator(std::make_shared<pool_strategy_t>());
+    return true;
+  };
+  for (size_t count = 10; count <= options.maxElements; count *= 10) {
+    if (count * sizeof(T) > options.maxBytes)
+      break;
+    RunCase<T>("std::deque", count, options, [] {
+      return std::deque<T>();
+    }, noMigrate);
+    RunCase<T>("std::list", count, options, [] {
+      return std::list<T>();
+    }, noMigrate);
+    if (count <= options.maxStupidElements)
+      RunCase<T>("deque_t<stupid>", count, options, [] {
+        return deque_t<T>(std::make_shared<stupid_strategy_t>());
+      }, [](auto &container) {
+        container.ChangeAllocator(std::make_shared<stupid_strategy_t>());
+        return true;
+      });
+    RunCase<T>("deque_t<pool>", count, options, [] {
+      return deque_t<T>(std::make_shared<pool_strategy_t>());
+    }, poolMigrate);
+    RunCase<T>("deque_t<static synchronized pool>", count, options, [] {
+      return deque_t<T, synchronized_strategy_t<pool_strategy_t>>();
+    }, noMigrate);
+    RunCase<T>("deque_t<arena>", count, options, [] {
+      return deque_t<T>(std::make_shared<arena_strategy_t>());
+    }, [](auto &container) {
+      container.ChangeAllocator(std::make_shared<arena_strategy_t>());
+      return true;
+    });
+    RunCase<T>("deque_t<numa>", count, options, [] {
+      return deque_t<T>(std::make_shared<numa_strategy_t>());
+    }, [](auto &container) {
+      container.ChangeAllocator(std::make_shared<numa_strategy_t>());
+      return true;
+    });
+    RunCase<T>("deque_t<thread cache>", count, options, [] {
+      return deque_t<T>(std::make_shared<thread_cache_strategy_t<pool_strategy_t>>());
+    }, poolMigrate);
+    RunCase<T>("chunked_deque_t<pool>", count, options, [] {
+      return chunked_deque_t<T>(std::make_shared<pool_strategy_t>());
+    }, poolMigrate);
+  }
+}
+
+/**
+ * Main program function.
+ * Usage: DequeBenchmark [maxElements [targetElements]]
+ * @param[in] argc number of arguments
+ * @param[in] argv arguments
+ * @return 0
+ */
+int main(int argc, char *argv[]) {
+  options_t options;
+  if (argc > 1)
+    options.maxElements = std::strtoull(argv[1], nullptr, 10);
+  if (argc > 2)
+    options.targetElements = std::strtoull(argv[2], nullptr, 10);
+  std::printf("%-24s %6s %9s %-14s %10s\n", "container", "size", "elements", "operation", "time");
+  RunElement<int>(options);
+  RunElement<payload_t<16>>(options);
+  RunElement<payload_t<64>>(options);
+  RunElement<payload_t<256>>(options);
+  return 0;
+}
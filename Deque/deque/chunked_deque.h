@@ -0,0 +1,1525 @@
+/**
+ * @file
+ * @brief Chunked deque header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains deque class with block storage
+ */
+
+#pragma once
+
+#ifndef __CHUNKED_DEQUE_H_INCLUDED
+#define __CHUNKED_DEQUE_H_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../allocator/allocator.h"
+#include "iterator_checks.h"
+
+/**
+ * @brief Template deque with block storage class.
+ * @tparam T deque elements type
+ * @tparam Strategy allocation strategy type, 'alloc_strategy_t' means runtime strategy
+ * @tparam BlockSize number of elements in one storage block
+ *
+ * Deque on map of fixed-size contiguous blocks with allocators.
+ * Blocks are allocated from strategy only when deque grows over block boundary,
+ * so there are no per element links and allocations.
+ * With static strategy type deque is default constructible and strategy calls have no virtual dispatch,
+ * functions with strategy argument are available only with runtime strategy.
+ */
+template <typename T, typename Strategy = alloc_strategy_t, size_t BlockSize = (sizeof(T) < 256 ? 4096 / sizeof(T) : 16)>
+class chunked_deque_t {
+  static_assert(BlockSize > 0, "Block size must be positive");
+
+private:
+  static constexpr bool isShareable = std::is_trivially_copyable<T>::value;  ///< blocks can be shared by snapshots flag
+
+  /**
+   * @brief Shared block references counter struct.
+   *
+   * Number of deques which use block, block is copied on write while it is used by several deques.
+   */
+  struct block_refs_t {
+    std::atomic<size_t> refs{1};  ///< number of deques using block
+  };
+
+  /**
+   * @brief Empty block header struct for blocks which are never shared.
+   */
+  struct no_refs_t {
+  };
+
+  /**
+   * @brief Deque storage block struct.
+   *
+   * Raw storage for 'BlockSize' elements of 'T' type.
+   * Blocks of trivially copyable elements have references counter to be shared by snapshots.
+   */
+  struct block_t : std::conditional<isShareable, block_refs_t, no_refs_t>::type {
+    alignas(T) unsigned char storage[sizeof(T) * BlockSize];  ///< elements storage
+
+    /**
+     * Default constructor. Leaves storage uninitialized.
+     */
+    block_t(void) {
+    }
+
+    /**
+     * Get block elements function.
+     * @return pointer to first element of block
+     */
+    T *Data(void) {
+      return reinterpret_cast<T *>(storage);
+    }
+  };
+
+  static constexpr size_t
+    minMapSize = 8,   ///< number of map entries on first allocation
+    bulkBatch = 256;  ///< maximal number of blocks allocated or freed by one strategy call
+
+  block_t **map;                          ///< blocks map, null entries are not allocated blocks
+  size_t
+    mapSize,                              ///< number of map entries
+    first,                                ///< index of first element from map beginning
+    size,                                 ///< number of elements
+    blockCount;                           ///< number of allocated blocks in map
+  block_t **spare;                        ///< spare blocks array of 'reservedBlocks' size
+  size_t
+    spareCount,                           ///< number of spare blocks
+    reservedBlocks;                       ///< number of blocks kept allocated on pops
+  bool mayBeShared;                       ///< blocks may be shared with snapshots flag
+
+  single_allocator_t<block_t, Strategy> allocator;  ///< allocator for blocks
+
+  /**
+   * Get element by index from map beginning function.
+   * @param[in] pos index from map beginning
+   * @return pointer to element
+   */
+  T *Slot(size_t pos) const {
+    return map[pos / BlockSize]->Data() + pos % BlockSize;
+  }
+
+  /**
+   * Drop reference to block which may be shared with snapshots function.
+   * @param[in] block map block
+   * @return true if block is still used by another deque, false if block is owned by this deque only
+   */
+  static bool ReleaseShared(block_t *block) {
+    if constexpr (isShareable) {
+      if (block->refs.load(std::memory_order_acquire) == 1)
+        return false;
+      if (block->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return true;
+      block->refs.store(1, std::memory_order_relaxed);
+    }
+    return false;
+  }
+
+  /**
+   * Copy map block shared with snapshots before write function.
+   * @param[in] block map index of block
+   */
+  void OwnBlock(size_t block) {
+    if constexpr (isShareable) {
+      block_t *shared = map[block];
+      if (shared == nullptr || shared->refs.load(std::memory_order_acquire) == 1)
+        return;
+      block_t *owned = spareCount != 0 ? spare[--spareCount] : allocator.alloc();
+      std::memcpy(owned->storage, shared->storage, sizeof(shared->storage));
+      map[block] = owned;
+      if (shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        shared->refs.store(1, std::memory_order_relaxed);
+        allocator.dealloc(shared);
+      }
+    }
+  }
+
+  /**
+   * Copy all map blocks shared with snapshots function.
+   * Called before deque elements are given for modification to several threads.
+   */
+  void OwnAllBlocks(void) {
+    if (!mayBeShared)
+      return;
+    for (size_t i = 0; i < mapSize; i++)
+      OwnBlock(i);
+    mayBeShared = false;
+  }
+
+  /**
+   * Get element for modification by index from map beginning function.
+   * Block shared with snapshots is copied first.
+   * @param[in] pos index from map beginning
+   * @return pointer to element
+   */
+  T *WritableSlot(size_t pos) {
+    if constexpr (isShareable)
+      if (mayBeShared)
+        OwnBlock(pos / BlockSize);
+    return Slot(pos);
+  }
+
+  /**
+   * Free all elements, blocks and map function.
+   */
+  void FreeMap(void) {
+    for (size_t i = 0; i < size; i++)
+      Slot(first + i)->~T();
+    for (size_t i = 0; i < mapSize; i++)
+      if (map[i] != nullptr && !ReleaseShared(map[i]))
+        allocator.dealloc(map[i]);
+    if (map != nullptr)
+      single_allocator_t<block_t *, Strategy>(allocator).deallocArray(map, mapSize);
+    map = nullptr;
+    mapSize = 0;
+    first = 0;
+    size = 0;
+    blockCount = 0;
+    mayBeShared = false;
+  }
+
+  /**
+   * Return all spare blocks to strategy and drop reservation function.
+   */
+  void FreeSpare(void) {
+    allocator.deallocRaw(spare, spareCount);
+    if (spare != nullptr)
+      single_allocator_t<block_t *, Strategy>(allocator).deallocArray(spare, reservedBlocks);
+    spare = nullptr;
+    spareCount = 0;
+    reservedBlocks = 0;
+  }
+
+  /**
+   * Free all elements, blocks, map and spare blocks function.
+   * If elements need no destruction and deque is the only user of strategy,
+   * strategy memory is released at once without freeing every block.
+   */
+  void FreeAll(void) {
+    if (!std::is_trivially_destructible<T>::value || !allocator.release()) {
+      FreeMap();
+      FreeSpare();
+      return;
+    }
+    map = nullptr;
+    mapSize = 0;
+    first = 0;
+    size = 0;
+    blockCount = 0;
+    spare = nullptr;
+    spareCount = 0;
+    reservedBlocks = 0;
+    mayBeShared = false;
+  }
+
+  /**
+   * Get block for map function. Spare blocks are used first.
+   * @return block
+   */
+  block_t *AcquireBlock(void) {
+    block_t *block = spareCount != 0 ? spare[--spareCount] : allocator.alloc();
+    blockCount++;
+    return block;
+  }
+
+  /**
+   * Keep block removed from map as spare function.
+   * Block shared with snapshots is left to them.
+   * @param[in] block removed block
+   * @return true if block is kept as spare or left to snapshots, false if it must be returned to strategy
+   */
+  bool KeepBlock(block_t *block) {
+    blockCount--;
+    if (ReleaseShared(block))
+      return true;
+    if (blockCount + spareCount >= reservedBlocks)
+      return false;
+    spare[spareCount++] = block;
+    return true;
+  }
+
+  /**
+   * Copy elements of another chunked deque to empty deque function.
+   * Existing map blocks are reused, missing blocks are allocated with batches.
+   * Elements keep offset in block of copied deque, so trivially copyable elements are copied by whole spans.
+   * @param[in] lhs deque to copy
+   */
+  void CopyElements(chunked_deque_t const &lhs) {
+    if (lhs.size == 0)
+      return;
+    size_t
+      offset = lhs.first % BlockSize,
+      usedBlocks = (offset + lhs.size - 1) / BlockSize + 1;
+    if (usedBlocks + 2 > mapSize / 2)
+      AdjustMap(usedBlocks);
+    size_t firstBlock = std::min(first / BlockSize, mapSize - usedBlocks);
+    AllocBlocks(firstBlock, firstBlock + usedBlocks);
+    for (size_t i = firstBlock; i < firstBlock + usedBlocks; i++)
+      OwnBlock(i);
+    first = firstBlock * BlockSize + offset;
+    lhs.ForEachBlock([this](T const *data, size_t count) {
+      if constexpr (std::is_trivially_copyable<T>::value) {
+        std::memcpy(static_cast<void *>(Slot(first + size)), data, count * sizeof(T));
+        size += count;
+      }
+      else
+        for (size_t i = 0; i < count; i++, size++)
+          new (Slot(first + size)) T(data[i]);
+    });
+  }
+
+  /**
+   * Copy elements of another chunked deque function.
+   * @param[in] lhs deque to copy
+   */
+  void CopyMap(chunked_deque_t const &lhs) {
+    map = nullptr;
+    mapSize = 0;
+    first = 0;
+    size = 0;
+    blockCount = 0;
+    try {
+      CopyElements(lhs);
+    }
+    catch (...) {
+      FreeMap();
+      throw;
+    }
+  }
+
+  /**
+   * Make room in map for blocks before first or after last element function.
+   *
+   * Map entries are rotated to place used blocks in the middle if map is sparse enough,
+   * otherwise map is reallocated with at least doubled size.
+   * @param[in] extraBlocks number of blocks to make room for on each side
+   */
+  void AdjustMap(size_t extraBlocks = 1) {
+    size_t usedBlocks = size == 0 ? 0 : (first + size - 1) / BlockSize - first / BlockSize + 1;
+    if (usedBlocks + extraBlocks + 2 > mapSize / 2) {
+      size_t
+        newMapSize = std::max({mapSize * 2, minMapSize, mapSize + 2 * (extraBlocks + 1)}),
+        shift = (newMapSize - mapSize) / 2;
+      block_t **newMap = single_allocator_t<block_t *, Strategy>(allocator).allocArray(newMapSize);
+      std::copy(map, map + mapSize, newMap + shift);
+      if (map != nullptr)
+        single_allocator_t<block_t *, Strategy>(allocator).deallocArray(map, mapSize);
+      map = newMap;
+      mapSize = newMapSize;
+      first += shift * BlockSize;
+      if (size == 0)
+        first = mapSize / 2 * BlockSize;
+      return;
+    }
+    size_t
+      usedBegin = first / BlockSize,
+      targetBegin = (mapSize - usedBlocks) / 2;
+    if (targetBegin > usedBegin)
+      std::rotate(map, map + mapSize - (targetBegin - usedBegin), map + mapSize);
+    else
+      std::rotate(map, map + (usedBegin - targetBegin), map + mapSize);
+    first = targetBegin * BlockSize + first % BlockSize;
+  }
+
+  /**
+   * Allocate all missing blocks in map range function.
+   * Spare blocks are used first, rest is allocated from strategy with batches.
+   * @param[in] beginBlock first block map index
+   * @param[in] endBlock map index after last block
+   */
+  void AllocBlocks(size_t beginBlock, size_t endBlock) {
+    block_t *blocks[bulkBatch];
+    size_t missing[bulkBatch];
+    while (beginBlock < endBlock) {
+      size_t count = 0;
+      for (; beginBlock < endBlock && count < bulkBatch; beginBlock++)
+        if (map[beginBlock] == nullptr)
+          missing[count++] = beginBlock;
+      size_t fromSpare = std::min(count, spareCount);
+      for (size_t i = 0; i < fromSpare; i++)
+        map[missing[i]] = spare[--spareCount];
+      blockCount += fromSpare;
+      if (count == fromSpare)
+        continue;
+      allocator.allocRaw(count - fromSpare, blocks);
+      for (size_t i = fromSpare; i < count; i++)
+        map[missing[i]] = new (blocks[i - fromSpare]) block_t();
+      blockCount += count - fromSpare;
+    }
+  }
+
+  /**
+   * Reserve storage for elements after last function.
+   * @param[in] count number of elements
+   */
+  void ReserveBack(size_t count) {
+    if (count == 0)
+      return;
+    if (first + size + count > mapSize * BlockSize)
+      AdjustMap((count + BlockSize - 1) / BlockSize + 1);
+    AllocBlocks((first + size) / BlockSize, (first + size + count - 1) / BlockSize + 1);
+  }
+
+  /**
+   * Reserve storage for elements before first function.
+   * @param[in] count number of elements
+   */
+  void ReserveFront(size_t count) {
+    if (count == 0)
+      return;
+    if (first < count)
+      AdjustMap((count + BlockSize - 1) / BlockSize + 1);
+    AllocBlocks((first - count) / BlockSize, (first - 1) / BlockSize + 1);
+  }
+
+  /**
+   * Detach map block if it contains no elements function.
+   * Detached blocks are kept as spare while reservation is not filled,
+   * rest is collected to array and returned to strategy when array is full.
+   * @param[in] block map index of block
+   * @param[in, out] blocks array of detached blocks
+   * @param[in, out] count number of detached blocks
+   */
+  void DetachBlockIfUnused(size_t block, block_t **blocks, size_t &count) {
+    if (size != 0 && block >= first / BlockSize && block <= (first + size - 1) / BlockSize)
+      return;
+    block_t *detached = map[block];
+    map[block] = nullptr;
+    if (KeepBlock(detached))
+      return;
+    blocks[count++] = detached;
+    if (count == bulkBatch) {
+      allocator.deallocRaw(blocks, count);
+      count = 0;
+    }
+  }
+
+  /**
+   * Prepare storage for element after last function.
+   * @return pointer to uninitialized element storage
+   */
+  T *PrepareBack(void) {
+    if (first + size == mapSize * BlockSize)
+      AdjustMap();
+    size_t block = (first + size) / BlockSize;
+    if (map[block] == nullptr)
+      map[block] = AcquireBlock();
+    return WritableSlot(first + size);
+  }
+
+  /**
+   * Prepare storage for element before first function.
+   * @return pointer to uninitialized element storage
+   */
+  T *PrepareFront(void) {
+    if (first == 0)
+      AdjustMap();
+    size_t block = (first - 1) / BlockSize;
+    if (map[block] == nullptr)
+      map[block] = AcquireBlock();
+    return WritableSlot(first - 1);
+  }
+
+  /**
+   * Free map block if it contains no elements function.
+   * Block is kept as spare while reservation is not filled.
+   * @param[in] block map index of block
+   */
+  void ReleaseBlockIfUnused(size_t block) {
+    if (size != 0 && block >= first / BlockSize && block <= (first + size - 1) / BlockSize)
+      return;
+    block_t *released = map[block];
+    map[block] = nullptr;
+    if (!KeepBlock(released))
+      allocator.dealloc(released);
+  }
+
+  /**
+   * Remove last element function. Deque must be not empty.
+   */
+  void EraseBack(void) {
+    Slot(first + size - 1)->~T();
+    size--;
+    ReleaseBlockIfUnused((first + size) / BlockSize);
+  }
+
+  /**
+   * Remove first element function. Deque must be not empty.
+   */
+  void EraseFront(void) {
+    Slot(first)->~T();
+    first++;
+    size--;
+    ReleaseBlockIfUnused((first - 1) / BlockSize);
+  }
+
+  /**
+   * Detach all map blocks without elements function.
+   * Blocks are kept as spare while reservation is not filled, rest is returned to strategy with batches.
+   */
+  void DetachUnusedBlocks(void) {
+    block_t *blocks[bulkBatch];
+    size_t detached = 0;
+    for (size_t i = 0; i < mapSize; i++)
+      if (map[i] != nullptr)
+        DetachBlockIfUnused(i, blocks, detached);
+    allocator.deallocRaw(blocks, detached);
+  }
+
+  /**
+   * Get bounds of deque range by storage blocks function.
+   * Ranges begin and end on block bounds, so one block is never shared by two ranges.
+   * @param[in] part range index
+   * @param[in] numOfParts number of ranges
+   * @return element indices from map beginning of range begin and end
+   */
+  std::pair<size_t, size_t> PartBounds(size_t part, size_t numOfParts) const {
+    size_t
+      firstBlock = first / BlockSize,
+      usedBlocks = (first + size - 1) / BlockSize - firstBlock + 1,
+      begin = (firstBlock + usedBlocks * part / numOfParts) * BlockSize,
+      end = (firstBlock + usedBlocks * (part + 1) / numOfParts) * BlockSize;
+    return {std::max(begin, first), std::min(end, first + size)};
+  }
+
+  /**
+   * Empty deque constructor by allocator.
+   * @param[in] alloc allocator for blocks
+   */
+  explicit chunked_deque_t(single_allocator_t<block_t, Strategy> const &alloc) :
+    map(nullptr), mapSize(0), first(0), size(0), blockCount(0), spare(nullptr), spareCount(0), reservedBlocks(0), mayBeShared(false), allocator(alloc) {
+  }
+
+  /**
+   * @brief Chunked deque iterator class.
+   * @tparam IsConst constant iterator flag
+   *
+   * Random access iterator, element is found by its index in blocks map.
+   * Iterators are invalidated by pushes which adjust map and by pops of iterated elements.
+   * Dereference of end iterator and moving over deque bounds throw only with checked iterators (see DEQUE_CHECKED_ITERATORS).
+   */
+  template <bool IsConst>
+  class basic_iterator_t {
+    template <bool> friend class basic_iterator_t;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;                          ///< iterator category
+    using value_type = T;                                                               ///< element type
+    using difference_type = std::ptrdiff_t;                                             ///< iterators distance type
+    using pointer = typename std::conditional<IsConst, T const *, T *>::type;           ///< element pointer type
+    using reference = typename std::conditional<IsConst, T const &, T &>::type;         ///< element reference type
+
+  private:
+    using deque_ptr_t = typename std::conditional<IsConst, chunked_deque_t const *, chunked_deque_t *>::type;  ///< iterated deque pointer type
+
+    deque_ptr_t deq;  ///< iterated deque
+    size_t pos;       ///< index of current element from map beginning
+
+  public:
+    /**
+     * Default constructor. Iterator is singular.
+     */
+    basic_iterator_t(void) : deq(nullptr), pos(0) {
+    }
+
+    /**
+     * Constructor by deque and position.
+     * @param[in] d deque for iterator
+     * @param[in] p index of element from map beginning
+     */
+    basic_iterator_t(deque_ptr_t d, size_t p) : deq(d), pos(p) {
+    }
+
+    /**
+     * Conversion constructor from modifying iterator to constant iterator.
+     * @tparam WasConst converted iterator constant flag
+     * @param[in] lhs iterator to convert
+     */
+    template <bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+    basic_iterator_t(basic_iterator_t<WasConst> const &lhs) : deq(lhs.deq), pos(lhs.pos) {
+    }
+
+    /**
+     * Equality operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator==(basic_iterator_t<IsConst1> const &lhs) const {
+      return pos == lhs.pos;
+    }
+
+    /**
+     * Inequality operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator!=(basic_iterator_t<IsConst1> const &lhs) const {
+      return pos != lhs.pos;
+    }
+
+    /**
+     * Less operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator<(basic_iterator_t<IsConst1> const &lhs) const {
+      return pos < lhs.pos;
+    }
+
+    /**
+     * Greater operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator>(basic_iterator_t<IsConst1> const &lhs) const {
+      return pos > lhs.pos;
+    }
+
+    /**
+     * Less or equal operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator<=(basic_iterator_t<IsConst1> const &lhs) const {
+      return pos <= lhs.pos;
+    }
+
+    /**
+     * Greater or equal operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator>=(basic_iterator_t<IsConst1> const &lhs) const {
+      return pos >= lhs.pos;
+    }
+
+    /**
+     * Operator * to provide pointer semantics.
+     * @return data reference
+     */
+    reference operator*(void) const {
+#if DEQUE_CHECKED_ITERATORS
+      if (pos == deq->first + deq->size)
+        throw std::exception("Try to use end iterator");
+#endif /* DEQUE_CHECKED_ITERATORS */
+      if constexpr (IsConst)
+        return *deq->Slot(pos);
+      else
+        return *deq->WritableSlot(pos);
+    }
+
+    /**
+     * Operator -> to provide pointer semantics.
+     * @return data pointer
+     */
+    pointer operator->(void) const {
+      return &**this;
+    }
+
+    /**
+     * Operator [] to access element by offset.
+     * @param[in] offset element offset from iterator
+     * @return data reference
+     */
+    reference operator[](difference_type offset) const {
+      if constexpr (IsConst)
+        return *deq->Slot(pos + offset);
+      else
+        return *deq->WritableSlot(pos + offset);
+    }
+
+    /**
+     * Prefix increment.
+     * @return current iterator value
+     */
+    basic_iterator_t &operator++(void) {
+#if DEQUE_CHECKED_ITERATORS
+      if (pos == deq->first + deq->size)
+        throw std::exception("Try to use end iterator");
+#endif /* DEQUE_CHECKED_ITERATORS */
+      pos++;
+      return *this;
+    }
+
+    /**
+     * Postfix increment.
+     * @param[in] unusedInteger unused argument
+     * @return previous iterator value
+     */
+    basic_iterator_t operator++(int unusedInteger) {
+      basic_iterator_t tmp{*this};
+      ++*this;
+      return tmp;
+    }
+
+    /**
+     * Prefix decrement.
+     * @return current iterator value
+     */
+    basic_iterator_t &operator--(void) {
+#if DEQUE_CHECKED_ITERATORS
+      if (pos == deq->first)
+        throw std::exception("Try to move before begin iterator");
+#endif /* DEQUE_CHECKED_ITERATORS */
+      pos--;
+      return *this;
+    }
+
+    /**
+     * Postfix decrement.
+     * @param[in] unusedInteger unused argument
+     * @return previous iterator value
+     */
+    basic_iterator_t operator--(int unusedInteger) {
+      basic_iterator_t tmp{*this};
+      --*this;
+      return tmp;
+    }
+
+    /**
+     * Move iterator forward operator.
+     * @param[in] offset number of elements to move
+     * @return current iterator value
+     */
+    basic_iterator_t &operator+=(difference_type offset) {
+      pos += offset;
+      return *this;
+    }
+
+    /**
+     * Move iterator backward operator.
+     * @param[in] offset number of elements to move
+     * @return current iterator value
+     */
+    basic_iterator_t &operator-=(difference_type offset) {
+      pos -= offset;
+      return *this;
+    }
+
+    /**
+     * Get moved forward iterator operator.
+     * @param[in] offset number of elements to move
+     * @return moved iterator
+     */
+    basic_iterator_t operator+(difference_type offset) const {
+      return basic_iterator_t(deq, pos + offset);
+    }
+
+    /**
+     * Get moved backward iterator operator.
+     * @param[in] offset number of elements to move
+     * @return moved iterator
+     */
+    basic_iterator_t operator-(difference_type offset) const {
+      return basic_iterator_t(deq, pos - offset);
+    }
+
+    /**
+     * Get distance between iterators operator.
+     * @tparam IsConst1 other iterator constant flag
+     * @param[in] lhs other iterator
+     * @return number of elements from other iterator to this one
+     */
+    template <bool IsConst1>
+    difference_type operator-(basic_iterator_t<IsConst1> const &lhs) const {
+      return static_cast<difference_type>(pos) - static_cast<difference_type>(lhs.pos);
+    }
+
+    /**
+     * Get moved forward iterator operator with offset first.
+     * @param[in] offset number of elements to move
+     * @param[in] it iterator to move
+     * @return moved iterator
+     */
+    friend basic_iterator_t operator+(difference_type offset, basic_iterator_t const &it) {
+      return it + offset;
+    }
+  };
+
+public:
+  using iterator_t = basic_iterator_t<false>;       ///< modifying iterator type
+  using const_iterator_t = basic_iterator_t<true>;  ///< constant iterator type
+
+  class snapshot_t;
+
+  /**
+   * Default constructor. Available only for static strategy.
+   */
+  chunked_deque_t(void) : map(nullptr), mapSize(0), first(0), size(0), blockCount(0), spare(nullptr), spareCount(0), reservedBlocks(0), mayBeShared(false) {
+  }
+
+  /**
+   * Constructor with strategy function.
+   * @param[in] strategy allocation strategy
+   */
+  chunked_deque_t(std::shared_ptr<alloc_strategy_t> const &strategy) :
+    map(nullptr), mapSize(0), first(0), size(0), blockCount(0), spare(nullptr), spareCount(0), reservedBlocks(0), mayBeShared(false), allocator(strategy) {
+  }
+
+  /**
+   * Copy constructor.
+   * @param[in] lhs instance to copy
+   */
+  chunked_deque_t(chunked_deque_t const &lhs) :
+    spare(nullptr), spareCount(0), reservedBlocks(0), mayBeShared(false), allocator(lhs.allocator) {
+    CopyMap(lhs);
+  }
+
+  /**
+   * Copy constructor with strategy function.
+   * @param[in] lhs instance to copy
+   * @param[in] strategy allocation strategy
+   */
+  chunked_deque_t(chunked_deque_t const &lhs, std::shared_ptr<alloc_strategy_t> const &strategy) :
+    spare(nullptr), spareCount(0), reservedBlocks(0), mayBeShared(false), allocator(strategy) {
+    CopyMap(lhs);
+  }
+
+  /**
+   * Move constructor.
+   * @param[in] rhs instance to copy
+   */
+  chunked_deque_t(chunked_deque_t &&rhs) :
+    map(rhs.map), mapSize(rhs.mapSize), first(rhs.first), size(rhs.size), blockCount(rhs.blockCount),
+    spare(rhs.spare), spareCount(rhs.spareCount), reservedBlocks(rhs.reservedBlocks), mayBeShared(rhs.mayBeShared),
+    allocator(rhs.allocator) {
+    rhs.map = nullptr;
+    rhs.mapSize = 0;
+    rhs.first = 0;
+    rhs.size = 0;
+    rhs.blockCount = 0;
+    rhs.spare = nullptr;
+    rhs.spareCount = 0;
+    rhs.reservedBlocks = 0;
+    rhs.mayBeShared = false;
+  }
+
+  /**
+   * Copy operator =.
+   * With equal allocators map and blocks are reused and reservation is kept,
+   * otherwise storage is freed and allocated from strategy of copied deque.
+   * @param[in] lhs instance to copy
+   */
+  void operator=(chunked_deque_t const &lhs) {
+    if (this == &lhs)
+      return;
+    if (allocator == lhs.allocator) {
+      for (size_t i = 0; i < size; i++)
+        Slot(first + i)->~T();
+      size = 0;
+      CopyElements(lhs);
+      DetachUnusedBlocks();
+      mayBeShared = false;
+      return;
+    }
+    FreeAll();
+    allocator = lhs.allocator;
+    CopyMap(lhs);
+  }
+
+  /**
+   * Copy with another allocator.
+   * @param[in] lhs instance to copy
+   * @param[in] strategy allocation strategy for deque
+   */
+  void Copy(chunked_deque_t const &lhs, std::shared_ptr<alloc_strategy_t> const &strategy) {
+    FreeAll();
+    allocator = single_allocator_t<block_t, Strategy>(strategy);
+    CopyMap(lhs);
+  }
+
+  /**
+   * Move operator =.
+   * @param[in] rhs rValue instance to copy
+   */
+  void operator=(chunked_deque_t &&rhs) {
+    if (this == &rhs)
+      return;
+    FreeAll();
+    allocator = rhs.allocator;
+    map = rhs.map;
+    mapSize = rhs.mapSize;
+    first = rhs.first;
+    size = rhs.size;
+    blockCount = rhs.blockCount;
+    spare = rhs.spare;
+    spareCount = rhs.spareCount;
+    reservedBlocks = rhs.reservedBlocks;
+    mayBeShared = rhs.mayBeShared;
+    rhs.map = nullptr;
+    rhs.mapSize = 0;
+    rhs.first = 0;
+    rhs.size = 0;
+    rhs.blockCount = 0;
+    rhs.spare = nullptr;
+    rhs.spareCount = 0;
+    rhs.reservedBlocks = 0;
+    rhs.mayBeShared = false;
+  }
+
+  /**
+   * Destructor.
+   */
+  ~chunked_deque_t(void) {
+    FreeAll();
+  }
+
+  /**
+   * Construct element back in place function.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   * @return reference to constructed element
+   */
+  template <typename... Args>
+  T &EmplaceBack(Args&&... constructorArgs) {
+    T *slot = new (PrepareBack()) T(std::forward<Args>(constructorArgs)...);
+    size++;
+    return *slot;
+  }
+
+  /**
+   * Construct element front in place function.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   * @return reference to constructed element
+   */
+  template <typename... Args>
+  T &EmplaceFront(Args&&... constructorArgs) {
+    T *slot = new (PrepareFront()) T(std::forward<Args>(constructorArgs)...);
+    first--;
+    size++;
+    return *slot;
+  }
+
+  /**
+   * Push element back function.
+   * @param[in] data data to push
+   */
+  void PushBack(T const &data) {
+    EmplaceBack(data);
+  }
+
+  /**
+   * Push element back with move function.
+   * @param[in] data data to push
+   */
+  void PushBack(T &&data) {
+    EmplaceBack(std::move(data));
+  }
+
+  /**
+   * Push element front function.
+   * @param[in] data data to push
+   */
+  void PushFront(T const &data) {
+    EmplaceFront(data);
+  }
+
+  /**
+   * Push element front with move function.
+   * @param[in] data data to push
+   */
+  void PushFront(T &&data) {
+    EmplaceFront(std::move(data));
+  }
+
+  /**
+   * Push range of elements back function.
+   * Storage for forward iterator ranges is reserved at once.
+   * @tparam InputIt range iterator type
+   * @param[in] rangeFirst range begin
+   * @param[in] rangeLast range end
+   */
+  template <typename InputIt>
+  void PushBack(InputIt rangeFirst, InputIt rangeLast) {
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    if (std::is_base_of<std::forward_iterator_tag, category>::value)
+      ReserveBack(static_cast<size_t>(std::distance(rangeFirst, rangeLast)));
+    for (; rangeFirst != rangeLast; ++rangeFirst)
+      PushBack(*rangeFirst);
+  }
+
+  /**
+   * Push list of elements back function.
+   * @param[in] list elements to push
+   */
+  void PushBack(std::initializer_list<T> list) {
+    PushBack(list.begin(), list.end());
+  }
+
+  /**
+   * Push range of elements front function.
+   * Range order is kept, so range first element becomes deque first element.
+   * Storage for forward iterator ranges is reserved at once.
+   * @tparam InputIt range iterator type
+   * @param[in] rangeFirst range begin
+   * @param[in] rangeLast range end
+   */
+  template <typename InputIt>
+  void PushFront(InputIt rangeFirst, InputIt rangeLast) {
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    if (!std::is_base_of<std::forward_iterator_tag, category>::value) {
+      chunked_deque_t tmp(allocator);
+      for (; rangeFirst != rangeLast; ++rangeFirst)
+        tmp.PushBack(*rangeFirst);
+      while (!tmp.IsEmpty())
+        PushFront(tmp.PopBack());
+      return;
+    }
+    size_t count = static_cast<size_t>(std::distance(rangeFirst, rangeLast)), built = 0;
+    ReserveFront(count);
+    if (count != 0)
+      WritableSlot(first - 1);
+    try {
+      for (; rangeFirst != rangeLast; ++rangeFirst, built++)
+        new (Slot(first - count + built)) T(*rangeFirst);
+    }
+    catch (...) {
+      for (size_t i = 0; i < built; i++)
+        Slot(first - count + i)->~T();
+      throw;
+    }
+    first -= count;
+    size += count;
+  }
+
+  /**
+   * Push list of elements front function.
+   * @param[in] list elements to push
+   */
+  void PushFront(std::initializer_list<T> list) {
+    PushFront(list.begin(), list.end());
+  }
+
+  /**
+   * Pop several elements back function.
+   * Elements are written in pop order, blocks are returned to strategy with batches.
+   * @tparam OutputIt output iterator type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @return number of poped elements
+   */
+  template <typename OutputIt>
+  size_t PopBack(size_t count, OutputIt out) {
+    block_t *blocks[bulkBatch];
+    size_t poped = 0, detached = 0;
+    try {
+      for (; poped < count && size != 0; poped++) {
+        T *slot = Slot(first + size - 1);
+        *out = std::move(*slot);
+        ++out;
+        slot->~T();
+        size--;
+        DetachBlockIfUnused((first + size) / BlockSize, blocks, detached);
+      }
+    }
+    catch (...) {
+      allocator.deallocRaw(blocks, detached);
+      throw;
+    }
+    allocator.deallocRaw(blocks, detached);
+    return poped;
+  }
+
+  /**
+   * Pop several elements front function.
+   * Elements are written in pop order, blocks are returned to strategy with batches.
+   * @tparam OutputIt output iterator type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @return number of poped elements
+   */
+  template <typename OutputIt>
+  size_t PopFront(size_t count, OutputIt out) {
+    block_t *blocks[bulkBatch];
+    size_t poped = 0, detached = 0;
+    try {
+      for (; poped < count && size != 0; poped++) {
+        T *slot = Slot(first);
+        *out = std::move(*slot);
+        ++out;
+        slot->~T();
+        first++;
+        size--;
+        DetachBlockIfUnused((first - 1) / BlockSize, blocks, detached);
+      }
+    }
+    catch (...) {
+      allocator.deallocRaw(blocks, detached);
+      throw;
+    }
+    allocator.deallocRaw(blocks, detached);
+    return poped;
+  }
+
+  /**
+   * Pop element back function.
+   * @return poped element
+   */
+  T PopBack(void) {
+    if (size == 0)
+      throw std::exception("Empty list");
+    T data = std::move(*Slot(first + size - 1));
+    EraseBack();
+    return data;
+  }
+
+  /**
+   * Pop element front function.
+   * @return poped element
+   */
+  T PopFront(void) {
+    if (size == 0)
+      throw std::exception("Empty list");
+    T data = std::move(*Slot(first));
+    EraseFront();
+    return data;
+  }
+
+  /**
+   * Try to pop element back function. Does not throw on empty deque.
+   * @param[out] data poped element, assigned with move
+   * @return true if element was poped, false if deque is empty
+   */
+  bool TryPopBack(T &data) {
+    if (size == 0)
+      return false;
+    data = std::move(*Slot(first + size - 1));
+    EraseBack();
+    return true;
+  }
+
+  /**
+   * Try to pop element front function. Does not throw on empty deque.
+   * @param[out] data poped element, assigned with move
+   * @return true if element was poped, false if deque is empty
+   */
+  bool TryPopFront(T &data) {
+    if (size == 0)
+      return false;
+    data = std::move(*Slot(first));
+    EraseFront();
+    return true;
+  }
+
+  /**
+   * Try to pop element back function. Does not throw on empty deque.
+   * @return poped element, empty if deque is empty
+   */
+  std::optional<T> TryPopBack(void) {
+    if (size == 0)
+      return std::nullopt;
+    std::optional<T> data(std::move(*Slot(first + size - 1)));
+    EraseBack();
+    return data;
+  }
+
+  /**
+   * Try to pop element front function. Does not throw on empty deque.
+   * @return poped element, empty if deque is empty
+   */
+  std::optional<T> TryPopFront(void) {
+    if (size == 0)
+      return std::nullopt;
+    std::optional<T> data(std::move(*Slot(first)));
+    EraseFront();
+    return data;
+  }
+
+  /**
+   * Is empty check function.
+   * @return true if deque is empty, false - otherwise
+   */
+  bool IsEmpty(void) const {
+    return size == 0;
+  }
+
+  /**
+   * Get number of elements function.
+   * @return number of elements
+   */
+  size_t Size(void) const {
+    return size;
+  }
+
+  /**
+   * Get number of elements allocated blocks can hold function.
+   * @return number of elements
+   */
+  size_t Capacity(void) const {
+    return (blockCount + spareCount) * BlockSize;
+  }
+
+  /**
+   * Reserve storage for elements function.
+   * Missing blocks are allocated from strategy with batches and kept as spare,
+   * pops keep freed blocks as spare while reservation is not filled.
+   * Reservation is dropped when deque strategy is replaced by assignment or by copying to new strategy.
+   * @param[in] count number of elements deque must hold without block allocations
+   */
+  void Reserve(size_t count) {
+    size_t neededBlocks = (count + BlockSize - 1) / BlockSize + 1;
+    if (count == 0 || neededBlocks <= reservedBlocks)
+      return;
+    block_t **newSpare = single_allocator_t<block_t *, Strategy>(allocator).allocArray(neededBlocks);
+    std::copy(spare, spare + spareCount, newSpare);
+    if (spare != nullptr)
+      single_allocator_t<block_t *, Strategy>(allocator).deallocArray(spare, reservedBlocks);
+    spare = newSpare;
+    reservedBlocks = neededBlocks;
+    if (neededBlocks + 2 > mapSize / 2)
+      AdjustMap(neededBlocks);
+    block_t *blocks[bulkBatch];
+    while (blockCount + spareCount < reservedBlocks) {
+      size_t batch = std::min(reservedBlocks - blockCount - spareCount, bulkBatch);
+      allocator.allocRaw(batch, blocks);
+      for (size_t i = 0; i < batch; i++)
+        spare[spareCount++] = new (blocks[i]) block_t();
+    }
+  }
+
+  /**
+   * Return spare and unused blocks to strategy and drop reservation function.
+   */
+  void ShrinkToFit(void) {
+    FreeSpare();
+    DetachUnusedBlocks();
+  }
+
+  /**
+   * Clear deque function.
+   * Without reservation all storage is freed, otherwise blocks are kept as spare while reservation is not filled.
+   */
+  void Clear(void) {
+    if (reservedBlocks == 0) {
+      FreeAll();
+      return;
+    }
+    for (size_t i = 0; i < size; i++)
+      Slot(first + i)->~T();
+    size = 0;
+    DetachUnusedBlocks();
+    first = mapSize / 2 * BlockSize;
+  }
+
+  /**
+   * Get element by index function. Index is not checked.
+   * @param[in] index element index from deque beginning
+   * @return reference to element
+   */
+  T &operator[](size_t index) {
+    return *WritableSlot(first + index);
+  }
+
+  /**
+   * Get constant element by index function. Index is not checked.
+   * @param[in] index element index from deque beginning
+   * @return constant reference to element
+   */
+  T const &operator[](size_t index) const {
+    return *Slot(first + index);
+  }
+
+  /**
+   * Get element by index with check function.
+   * @param[in] index element index from deque beginning
+   * @return reference to element
+   */
+  T &At(size_t index) {
+    if (index >= size)
+      throw std::exception("Index out of range");
+    return *WritableSlot(first + index);
+  }
+
+  /**
+   * Get constant element by index with check function.
+   * @param[in] index element index from deque beginning
+   * @return constant reference to element
+   */
+  T const &At(size_t index) const {
+    if (index >= size)
+      throw std::exception("Index out of range");
+    return *Slot(first + index);
+  }
+
+  /**
+   * Make read-only snapshot of deque function. Available only for trivially copyable elements.
+   * Snapshot shares storage blocks with deque, so it is made in time proportional to number of blocks.
+   * Deque copies shared block before it writes to it, so snapshot contents never change.
+   * Snapshot is made by thread which owns deque, then it can be read and destroyed by any thread.
+   * Shared blocks are returned to strategy by their last user, so strategy of deque with snapshots destroyed
+   * by other threads has to be safe for concurrent calls (see 'synchronized_strategy_t').
+   * @return snapshot
+   */
+  snapshot_t Snapshot(void) {
+    static_assert(isShareable, "Snapshots are available only for trivially copyable elements");
+    chunked_deque_t view(allocator);
+    if (size != 0) {
+      size_t
+        firstBlock = first / BlockSize,
+        usedBlocks = (first + size - 1) / BlockSize - firstBlock + 1;
+      view.map = single_allocator_t<block_t *, Strategy>(allocator).allocArray(usedBlocks);
+      for (size_t i = 0; i < usedBlocks; i++) {
+        view.map[i] = map[firstBlock + i];
+        view.map[i]->refs.fetch_add(1, std::memory_order_relaxed);
+      }
+      view.mapSize = usedBlocks;
+      view.first = first % BlockSize;
+      view.size = size;
+      view.blockCount = usedBlocks;
+      view.mayBeShared = true;
+      mayBeShared = true;
+    }
+    return snapshot_t(std::move(view));
+  }
+
+  /**
+   * Change allocator strategy function.
+   * If deque is the only owner of its strategy and new strategy absorbs its memory, blocks are kept without copying.
+   * Otherwise elements are moved to blocks allocated from new strategy with batches and old blocks are freed,
+   * reservation is dropped in this case.
+   * @param[in] strategy allocation strategy for deque
+   */
+  void ChangeAllocator(std::shared_ptr<alloc_strategy_t> const &strategy) {
+    if (allocator.migrate(strategy))
+      return;
+    chunked_deque_t moved(strategy);
+    moved.ReserveBack(size);
+    for (size_t i = 0; i < size; i++)
+      moved.EmplaceBack(std::move(*Slot(first + i)));
+    *this = std::move(moved);
+  }
+
+  /**
+   * Split deque into ranges of neighbouring elements function.
+   * Ranges are made of whole storage blocks, so threads working on different ranges do not share blocks.
+   * Blocks shared with snapshots are copied at once, so ranges can be modified concurrently.
+   * @param[in] numOfParts maximal number of ranges
+   * @return ranges in deque order, no empty ranges
+   */
+  std::vector<std::pair<iterator_t, iterator_t>> Partition(size_t numOfParts) {
+    std::vector<std::pair<iterator_t, iterator_t>> parts;
+    if (size == 0)
+      return parts;
+    OwnAllBlocks();
+    numOfParts = std::min(std::max<size_t>(numOfParts, 1), (first + size - 1) / BlockSize - first / BlockSize + 1);
+    for (size_t part = 0; part < numOfParts; part++) {
+      std::pair<size_t, size_t> bounds = PartBounds(part, numOfParts);
+      parts.emplace_back(iterator_t(this, bounds.first), iterator_t(this, bounds.second));
+    }
+    return parts;
+  }
+
+  /**
+   * Split constant deque into ranges of neighbouring elements function.
+   * Ranges are made of whole storage blocks, so threads working on different ranges do not share blocks.
+   * @param[in] numOfParts maximal number of ranges
+   * @return ranges in deque order, no empty ranges
+   */
+  std::vector<std::pair<const_iterator_t, const_iterator_t>> Partition(size_t numOfParts) const {
+    std::vector<std::pair<const_iterator_t, const_iterator_t>> parts;
+    if (size == 0)
+      return parts;
+    numOfParts = std::min(std::max<size_t>(numOfParts, 1), (first + size - 1) / BlockSize - first / BlockSize + 1);
+    for (size_t part = 0; part < numOfParts; part++) {
+      std::pair<size_t, size_t> bounds = PartBounds(part, numOfParts);
+      parts.emplace_back(const_iterator_t(this, bounds.first), const_iterator_t(this, bounds.second));
+    }
+    return parts;
+  }
+
+  /**
+   * Call function for every element function.
+   * Elements are visited in order by plain loops over blocks without iterator checks.
+   * @tparam Fn function type, called with element reference
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEach(Fn fn) {
+    ForEachBlock([&fn](T *data, size_t count) {
+      for (size_t i = 0; i < count; i++)
+        fn(data[i]);
+    });
+  }
+
+  /**
+   * Call function for every constant element function.
+   * Elements are visited in order by plain loops over blocks without iterator checks.
+   * @tparam Fn function type, called with constant element reference
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEach(Fn fn) const {
+    ForEachBlock([&fn](T const *data, size_t count) {
+      for (size_t i = 0; i < count; i++)
+        fn(data[i]);
+    });
+  }
+
+  /**
+   * Call function for every contiguous span of elements function.
+   * Spans are used parts of storage blocks in deque order, so caller loop over span can be vectorized.
+   * @tparam Fn function type, called with pointer to first span element and number of span elements
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEachBlock(Fn fn) {
+    for (size_t pos = first, last = first + size; pos < last;) {
+      size_t count = std::min(BlockSize - pos % BlockSize, last - pos);
+      fn(WritableSlot(pos), count);
+      pos += count;
+    }
+  }
+
+  /**
+   * Call function for every contiguous span of constant elements function.
+   * Spans are used parts of storage blocks in deque order, so caller loop over span can be vectorized.
+   * @tparam Fn function type, called with pointer to first constant span element and number of span elements
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEachBlock(Fn fn) const {
+    for (size_t pos = first, last = first + size; pos < last;) {
+      size_t count = std::min(BlockSize - pos % BlockSize, last - pos);
+      fn(static_cast<T const *>(Slot(pos)), count);
+      pos += count;
+    }
+  }
+
+  /**
+   * Get begin iterator function.
+   * @return begin iterator
+   */
+  iterator_t begin(void) {
+    return iterator_t(this, first);
+  }
+
+  /**
+   * Get end iterator function.
+   * @return end iterator
+   */
+  iterator_t end(void) {
+    return iterator_t(this, first + size);
+  }
+
+  /**
+   * Get constant begin iterator function.
+   * @return constant begin iterator
+   */
+  const_iterator_t begin(void) const {
+    return const_iterator_t(this, first);
+  }
+
+  /**
+   * Get constant end iterator function.
+   * @return constant end iterator
+   */
+  const_iterator_t end(void) const {
+    return const_iterator_t(this, first + size);
+  }
+
+  /**
+   * Get constant begin iterator function.
+   * @return constant begin iterator
+   */
+  const_iterator_t cbegin(void) const {
+    return begin();
+  }
+
+  /**
+   * Get constant end iterator function.
+   * @return constant end iterator
+   */
+  const_iterator_t cend(void) const {
+    return end();
+  }
+};
+
+/**
+ * @brief Chunked deque snapshot class.
+ * @tparam T deque elements type
+ * @tparam Strategy allocation strategy type
+ * @tparam BlockSize number of elements in one storage block
+ *
+ * Read-only view of deque contents made by 'Snapshot' function, storage blocks are shared with deque.
+ */
+template <typename T, typename Strategy, size_t BlockSize>
+class chunked_deque_t<T, Strategy, BlockSize>::snapshot_t {
+  friend class chunked_deque_t;
+
+private:
+  chunked_deque_t view;  ///< deque sharing blocks with snapshot origin
+
+  /**
+   * Constructor by deque sharing blocks.
+   * @param[in] deq deque to take
+   */
+  explicit snapshot_t(chunked_deque_t &&deq) : view(std::move(deq)) {
+  }
+
+public:
+  /**
+   * Default move constructor.
+   * @param[in] rhs instance to move
+   */
+  snapshot_t(snapshot_t &&rhs) = default;
+
+  /**
+   * Default move operator =.
+   * @param[in] rhs instance to move
+   * @return reference to this instance
+   */
+  snapshot_t &operator=(snapshot_t &&rhs) = default;
+
+  /**
+   * Get snapshot contents operator.
+   * @return constant reference to deque with snapshot contents
+   */
+  chunked_deque_t const &operator*(void) const {
+    return view;
+  }
+
+  /**
+   * Access snapshot contents operator.
+   * @return constant pointer to deque with snapshot contents
+   */
+  chunked_deque_t const *operator->(void) const {
+    return &view;
+  }
+};
+
+/**
+ * Operator<< for chunked deque and output stream.
+ * @tparam T deque elements type
+ * @tparam Strategy allocation strategy type
+ * @tparam BlockSize number of elements in one storage block
+ * @param[in] stream output stream
+ * @param[in] deq deque to output
+ * @return reference to stream
+ */
+template <typename T, typename Strategy, size_t BlockSize>
+std::ostream &operator<<(std::ostream &stream, chunked_deque_t<T, Strategy, BlockSize> const &deq) {
+  for (T const &data : deq)
+    stream << data << ", ";
+  return stream;
+}
+
+#endif /* __CHUNKED_DEQUE_H_INCLUDED */
@@ -0,0 +1,1032 @@
+/**
+ * @file
+ * @brief Concurrent deque header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains lock-free deques for concurrent producers and consumers
+ */
+
+#pragma once
+
+#ifndef __CONCURRENT_DEQUE_H_INCLUDED
+#define __CONCURRENT_DEQUE_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <optional>
+
+#include "../allocator/allocator.h"
+#include "event_count.h"
+#include "coroutine_waiters.h"
+
+/**
+ * @brief Concurrent deque mode enum.
+ */
+enum class concurrency_mode_t {
+  SPSC,  ///< unbounded lock-free single producer (PushBack) and single consumer (PopFront)
+  MPMC   ///< bounded lock-free multiple producers (PushBack) and multiple consumers (PopFront)
+};
+
+/**
+ * @brief Template concurrent deque class.
+ * @tparam T deque elements type
+ * @tparam Mode concurrency mode
+ * @tparam Strategy allocation strategy type, 'alloc_strategy_t' means runtime strategy
+ *
+ * Strategy is called from producer and consumer threads,
+ * so it has to be safe for concurrent calls (see 'synchronized_strategy_t' and 'thread_cache_strategy_t').
+ * Consumers may sleep until element is pushed with WaitPopFront functions (see 'event_count_t').
+ * With C++20 coroutines consumers may await AsyncPopFront, and producers of bounded deque may await AsyncPushBack;
+ * suspended coroutine is resumed directly by thread which made its operation possible (see 'coroutine_waiters_t').
+ */
+template <typename T, concurrency_mode_t Mode, typename Strategy = alloc_strategy_t>
+class concurrent_deque_t;
+
+/**
+ * @brief Template single producer single consumer concurrent deque class.
+ * @tparam T deque elements type
+ * @tparam Strategy allocation strategy type, 'alloc_strategy_t' means runtime strategy
+ *
+ * Unbounded lock-free deque on list of fixed-size segments.
+ * Producer calls only PushBack/EmplaceBack, consumer calls only PopFront/TryPopFront.
+ * Strategy is called once per segment: producer allocates segments and consumer frees them.
+ */
+template <typename T, typename Strategy>
+class concurrent_deque_t<T, concurrency_mode_t::SPSC, Strategy> {
+private:
+  static constexpr size_t
+    cacheLine = 64,                                         ///< cache line size to separate producer and consumer data
+    segmentSize = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;  ///< number of elements in one segment
+
+  /**
+   * @brief Deque segment struct.
+   *
+   * Raw storage for 'segmentSize' elements of 'T' type with link to next segment.
+   * Segment starts at cache line, so its link does not share line with other blocks.
+   */
+  struct alignas(cacheLine) segment_t {
+    std::atomic<segment_t *> next;                              ///< next segment, published with element count
+    alignas(T) unsigned char storage[sizeof(T) * segmentSize];  ///< elements storage
+
+    /**
+     * Default constructor. Leaves storage uninitialized.
+     */
+    segment_t(void) : next(nullptr) {
+    }
+
+    /**
+     * Get element by index function.
+     * @param[in] index element index in segment
+     * @return pointer to element
+     */
+    T *Slot(size_t index) {
+      return reinterpret_cast<T *>(storage) + index;
+    }
+  };
+
+  single_allocator_t<segment_t, Strategy> allocator;  ///< allocator for segments
+
+  alignas(cacheLine) segment_t *tail;                 ///< producer segment
+  size_t
+    tailIndex,                                        ///< producer segment number
+    pushPos;                                          ///< producer number of pushed elements
+  alignas(cacheLine) std::atomic<size_t> pushed;      ///< published number of pushed elements
+  alignas(cacheLine) segment_t *head;                 ///< consumer segment
+  size_t
+    headIndex,                                        ///< consumer segment number
+    popPos;                                           ///< consumer number of poped elements
+  alignas(cacheLine) std::atomic<size_t> poped;       ///< published number of poped elements
+  alignas(cacheLine) event_count_t notEmpty;          ///< consumer wake up on push
+#ifdef __cpp_impl_coroutine
+  coroutine_waiters_t popWaiters;                     ///< suspended consumer coroutines
+#endif
+
+  /**
+   * Move consumer to segment of next element function. Consumer only.
+   * @return pointer to next element
+   */
+  T *FrontSlot(void) {
+    if (popPos / segmentSize != headIndex) {
+      segment_t *next = head->next.load(std::memory_order_relaxed);
+      allocator.dealloc(head);
+      head = next;
+      headIndex++;
+    }
+    return head->Slot(popPos % segmentSize);
+  }
+
+#ifdef __cpp_impl_coroutine
+  /**
+   * @brief Pop front awaiter class.
+   *
+   * Suspended consumer is resumed by producer, which pops pushed element for it.
+   */
+  class pop_awaiter_t : public coroutine_waiters_t::waiter_t {
+  private:
+    friend class concurrent_deque_t;
+
+    concurrent_deque_t &deque;  ///< deque to pop from
+    std::optional<T> data;      ///< poped element
+    std::exception_ptr error;   ///< exception thrown while element was poped for suspended consumer
+
+  public:
+    /**
+     * Constructor with deque function.
+     * @param[in] deque deque to pop from
+     */
+    explicit pop_awaiter_t(concurrent_deque_t &deque) : deque(deque) {
+    }
+
+    /**
+     * Try to pop without suspension function.
+     * @return true if element was poped, false - otherwise
+     */
+    bool await_ready(void) {
+      return deque.PopFront(1, &data) != 0;
+    }
+
+    /**
+     * Register coroutine in deque function.
+     * @param[in] handle awaiting coroutine
+     * @return true if coroutine is suspended, false if element was poped
+     */
+    bool await_suspend(std::coroutine_handle<> handle) {
+      this->handle = handle;
+      return deque.popWaiters.Suspend(this, [this] {
+        return deque.PopFront(1, &data) != 0;
+      });
+    }
+
+    /**
+     * Get poped element function. Exception thrown while element was poped by producer is rethrown here.
+     * @return poped element
+     */
+    T await_resume(void) {
+      if (error)
+        std::rethrow_exception(error);
+      return std::move(*data);
+    }
+  };
+
+  /**
+   * Pop elements for suspended consumer and resume it function. Producer only.
+   * Exception of element move is passed to consumer, so producer is not affected.
+   */
+  void ResumePopWaiters(void) {
+    popWaiters.Resume([this](coroutine_waiters_t::waiter_t *waiter) {
+      pop_awaiter_t *awaiter = static_cast<pop_awaiter_t *>(waiter);
+      try {
+        return PopFront(1, &awaiter->data) != 0;
+      }
+      catch (...) {
+        awaiter->error = std::current_exception();
+        return true;
+      }
+    });
+  }
+#endif
+
+public:
+  /**
+   * Default constructor. Available only for static strategy.
+   */
+  concurrent_deque_t(void) : tailIndex(0), pushPos(0), pushed(0), headIndex(0), popPos(0), poped(0) {
+    head = tail = allocator.alloc();
+  }
+
+  /**
+   * Constructor with strategy function.
+   * @param[in] strategy allocation strategy
+   */
+  concurrent_deque_t(std::shared_ptr<alloc_strategy_t> const &strategy) :
+    allocator(strategy), tailIndex(0), pushPos(0), pushed(0), headIndex(0), popPos(0), poped(0) {
+    head = tail = allocator.alloc();
+  }
+
+  /**
+   * Deleted copy constructor.
+   */
+  concurrent_deque_t(concurrent_deque_t const &) = delete;
+
+  /**
+   * Deleted copy operator =.
+   */
+  concurrent_deque_t &operator=(concurrent_deque_t const &) = delete;
+
+  /**
+   * Destructor.
+   */
+  ~concurrent_deque_t(void) {
+    for (; popPos != pushPos; popPos++)
+      FrontSlot()->~T();
+    while (head != nullptr) {
+      segment_t *next = head->next.load(std::memory_order_relaxed);
+      allocator.dealloc(head);
+      head = next;
+    }
+  }
+
+  /**
+   * Construct element back in place function. Producer only.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   */
+  template <typename... Args>
+  void EmplaceBack(Args&&... constructorArgs) {
+    if (pushPos / segmentSize != tailIndex) {
+      segment_t *segment = allocator.alloc();
+      tail->next.store(segment, std::memory_order_relaxed);
+      tail = segment;
+      tailIndex++;
+    }
+    new (tail->Slot(pushPos % segmentSize)) T(std::forward<Args>(constructorArgs)...);
+    pushPos++;
+    pushed.store(pushPos, std::memory_order_release);
+    notEmpty.Notify();
+#ifdef __cpp_impl_coroutine
+    ResumePopWaiters();
+#endif
+  }
+
+  /**
+   * Push element back function. Producer only.
+   * @param[in] data data to push
+   */
+  void PushBack(T const &data) {
+    EmplaceBack(data);
+  }
+
+  /**
+   * Push element back with move function. Producer only.
+   * @param[in] data data to push
+   */
+  void PushBack(T &&data) {
+    EmplaceBack(std::move(data));
+  }
+
+  /**
+   * Try to pop element front function. Consumer only.
+   * @param[out] data poped element
+   * @return true if element was poped, false if deque is empty
+   */
+  bool TryPopFront(T &data) {
+    if (popPos == pushed.load(std::memory_order_acquire))
+      return false;
+    T *slot = FrontSlot();
+    data = std::move(*slot);
+    slot->~T();
+    popPos++;
+    poped.store(popPos, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Pop element front function. Consumer only.
+   * @return poped element
+   */
+  T PopFront(void) {
+    if (popPos == pushed.load(std::memory_order_acquire))
+      throw std::exception("Empty list");
+    T *slot = FrontSlot();
+    T data = std::move(*slot);
+    slot->~T();
+    popPos++;
+    poped.store(popPos, std::memory_order_release);
+    return data;
+  }
+
+  /**
+   * Pop several elements front function. Consumer only.
+   * Consumer position is published once for all elements.
+   * @tparam OutputIt output iterator type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @return number of poped elements
+   */
+  template <typename OutputIt>
+  size_t PopFront(size_t count, OutputIt out) {
+    size_t available = pushed.load(std::memory_order_acquire) - popPos;
+    if (count > available)
+      count = available;
+    for (size_t i = 0; i < count; i++) {
+      T *slot = FrontSlot();
+      *out = std::move(*slot);
+      ++out;
+      slot->~T();
+      popPos++;
+    }
+    if (count != 0)
+      poped.store(popPos, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * Wait for element and pop it front function. Consumer only.
+   * @return poped element
+   */
+  T WaitPopFront(void) {
+    std::optional<T> data;
+    notEmpty.Wait([this, &data] {
+      return PopFront(1, &data) != 0;
+    });
+    return std::move(*data);
+  }
+
+  /**
+   * Wait for element and pop it front with timeout function. Consumer only.
+   * @tparam Rep timeout representation type
+   * @tparam Period timeout period type
+   * @param[out] data poped element
+   * @param[in] timeout maximal time to wait
+   * @return true if element was poped, false on timeout
+   */
+  template <typename Rep, typename Period>
+  bool WaitPopFront(T &data, std::chrono::duration<Rep, Period> const &timeout) {
+    event_count_t::clock_t::time_point deadline = event_count_t::Deadline(timeout);
+    return notEmpty.Wait([this, &data] {
+      return TryPopFront(data);
+    }, &deadline);
+  }
+
+  /**
+   * Wait for element and pop it front with timeout function. Consumer only.
+   * @tparam Rep timeout representation type
+   * @tparam Period timeout period type
+   * @param[in] timeout maximal time to wait
+   * @return poped element, empty on timeout
+   */
+  template <typename Rep, typename Period>
+  std::optional<T> WaitPopFront(std::chrono::duration<Rep, Period> const &timeout) {
+    std::optional<T> data;
+    event_count_t::clock_t::time_point deadline = event_count_t::Deadline(timeout);
+    notEmpty.Wait([this, &data] {
+      return PopFront(1, &data) != 0;
+    }, &deadline);
+    return data;
+  }
+
+  /**
+   * Wait for elements and pop several of them front with timeout function. Consumer only.
+   * Waits until at least one element is available, then pops available elements without waiting.
+   * @tparam OutputIt output iterator type
+   * @tparam Rep timeout representation type
+   * @tparam Period timeout period type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @param[in] timeout maximal time to wait
+   * @return number of poped elements, 0 on timeout
+   */
+  template <typename OutputIt, typename Rep, typename Period>
+  size_t WaitPopFrontN(size_t count, OutputIt out, std::chrono::duration<Rep, Period> const &timeout) {
+    size_t popedCount = 0;
+    event_count_t::clock_t::time_point deadline = event_count_t::Deadline(timeout);
+    notEmpty.Wait([this, count, &out, &popedCount] {
+      popedCount = PopFront(count, out);
+      return popedCount != 0 || count == 0;
+    }, &deadline);
+    return popedCount;
+  }
+
+#ifdef __cpp_impl_coroutine
+  /**
+   * Await element and pop it front function. Consumer only.
+   * While coroutine is suspended consumer must not pop with other functions.
+   * Coroutine is resumed on producer thread, and deque must outlive it.
+   * @return awaiter which gives poped element
+   */
+  pop_awaiter_t AsyncPopFront(void) {
+    return pop_awaiter_t(*this);
+  }
+#endif
+
+  /**
+   * Is empty check function. Result may be outdated when it is returned.
+   * @return true if deque is empty, false - otherwise
+   */
+  bool IsEmpty(void) const {
+    return poped.load(std::memory_order_acquire) == pushed.load(std::memory_order_acquire);
+  }
+};
+
+/**
+ * @brief Template multiple producers multiple consumers concurrent deque class.
+ * @tparam T deque elements type
+ * @tparam Strategy allocation strategy type, 'alloc_strategy_t' means runtime strategy
+ *
+ * Bounded lock-free deque on ring of cells with sequence numbers.
+ * Producers call PushBack/TryPushBack, consumers call PopFront/TryPopFront.
+ * Storage is allocated from strategy once at construction.
+ */
+template <typename T, typename Strategy>
+class concurrent_deque_t<T, concurrency_mode_t::MPMC, Strategy> {
+private:
+  static constexpr size_t cacheLine = 64;  ///< cache line size to separate producers and consumers data
+
+  /**
+   * @brief Deque cell struct.
+   *
+   * Storage for one element with sequence number of its state.
+   */
+  struct cell_t {
+    std::atomic<size_t> sequence;                ///< cell sequence number
+    bool hasData;                                ///< element was constructed flag, false if constructor has thrown
+    alignas(T) unsigned char storage[sizeof(T)]; ///< element storage
+
+    /**
+     * Default constructor. Leaves storage uninitialized.
+     */
+    cell_t(void) : sequence(0), hasData(false) {
+    }
+
+    /**
+     * Get element function.
+     * @return pointer to element
+     */
+    T *Data(void) {
+      return reinterpret_cast<T *>(storage);
+    }
+  };
+
+  single_allocator_t<cell_t, Strategy> allocator;  ///< allocator for cells
+  cell_t *cells;                                   ///< ring of cells
+  size_t mask;                                     ///< capacity minus one
+  alignas(cacheLine) std::atomic<size_t> pushPos;  ///< producers position
+  alignas(cacheLine) std::atomic<size_t> popPos;   ///< consumers position
+  alignas(cacheLine) event_count_t notEmpty;       ///< consumers wake up on push
+#ifdef __cpp_impl_coroutine
+  coroutine_waiters_t
+    popWaiters,                                    ///< suspended consumer coroutines
+    pushWaiters;                                   ///< suspended producer coroutines
+#endif
+
+  /**
+   * Round capacity up to power of two function.
+   * @param[in] capacity requested capacity
+   * @return power of two capacity
+   */
+  static size_t RoundCapacity(size_t capacity) {
+    size_t result = 2;
+    while (result < capacity)
+      result *= 2;
+    return result;
+  }
+
+  /**
+   * Allocate cells ring function.
+   * @param[in] capacity requested capacity
+   */
+  void InitCells(size_t capacity) {
+    capacity = RoundCapacity(capacity);
+    cells = allocator.allocArray(capacity);
+    mask = capacity - 1;
+    for (size_t i = 0; i < capacity; i++)
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    pushPos.store(0, std::memory_order_relaxed);
+    popPos.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * Acquire cell for push function.
+   * @return cell to construct element in, nullptr if deque is full
+   */
+  cell_t *AcquirePush(void) {
+    size_t pos = pushPos.load(std::memory_order_relaxed);
+    for (;;) {
+      cell_t *cell = cells + (pos & mask);
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      if (sequence == pos) {
+        if (pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+          return cell;
+      }
+      else if (sequence < pos)
+        return nullptr;
+      else
+        pos = pushPos.load(std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Acquire cell for pop function.
+   * Cells without element are released and skipped.
+   * @param[out] pos acquired position
+   * @return cell with element, nullptr if deque is empty
+   */
+  cell_t *AcquirePop(size_t &pos) {
+    pos = popPos.load(std::memory_order_relaxed);
+    for (;;) {
+      cell_t *cell = cells + (pos & mask);
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      if (sequence == pos + 1) {
+        if (popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          if (cell->hasData)
+            return cell;
+          cell->sequence.store(pos + mask + 1, std::memory_order_release);
+          pos = popPos.load(std::memory_order_relaxed);
+        }
+      }
+      else if (sequence < pos + 1)
+        return nullptr;
+      else
+        pos = popPos.load(std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Destroy element and release cell for producers function.
+   * @param[in] cell cell with element
+   * @param[in] pos cell position
+   */
+  void ReleasePop(cell_t *cell, size_t pos) {
+    cell->Data()->~T();
+    cell->hasData = false;
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+  }
+
+  /**
+   * Try to construct element back in place without notification function.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   * @return true if element was pushed, false if deque is full
+   */
+  template <typename... Args>
+  bool TryEmplaceCell(Args&&... constructorArgs) {
+    cell_t *cell = AcquirePush();
+    if (cell == nullptr)
+      return false;
+    size_t pos = cell->sequence.load(std::memory_order_relaxed);
+    try {
+      new (cell->Data()) T(std::forward<Args>(constructorArgs)...);
+    }
+    catch (...) {
+      // cell is already taken by this producer, so it is published without element
+      cell->sequence.store(pos + 1, std::memory_order_release);
+      throw;
+    }
+    cell->hasData = true;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Pop several elements front without notification function.
+   * Every element is acquired separately, so elements of several consumers may interleave.
+   * @tparam OutputIt output iterator type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @return number of poped elements
+   */
+  template <typename OutputIt>
+  size_t PopCells(size_t count, OutputIt out) {
+    size_t popedCount = 0;
+    for (size_t pos; popedCount < count; popedCount++) {
+      cell_t *cell = AcquirePop(pos);
+      if (cell == nullptr)
+        break;
+      try {
+        *out = std::move(*cell->Data());
+        ++out;
+      }
+      catch (...) {
+        ReleasePop(cell, pos);
+        throw;
+      }
+      ReleasePop(cell, pos);
+    }
+    return popedCount;
+  }
+
+#ifdef __cpp_impl_coroutine
+  /**
+   * @brief Pop front awaiter class.
+   *
+   * Suspended consumer is resumed by producer, which pops pushed element for it.
+   */
+  class pop_awaiter_t : public coroutine_waiters_t::waiter_t {
+  private:
+    friend class concurrent_deque_t;
+
+    concurrent_deque_t &deque;  ///< deque to pop from
+    std::optional<T> data;      ///< poped element
+    std::exception_ptr error;   ///< exception thrown while element was poped for suspended consumer
+
+  public:
+    /**
+     * Constructor with deque function.
+     * @param[in] deque deque to pop from
+     */
+    explicit pop_awaiter_t(concurrent_deque_t &deque) : deque(deque) {
+    }
+
+    /**
+     * Try to pop without suspension function.
+     * @return true if element was poped, false - otherwise
+     */
+    bool await_ready(void) {
+      return deque.PopFront(1, &data) != 0;
+    }
+
+    /**
+     * Register coroutine in deque function.
+     * @param[in] handle awaiting coroutine
+     * @return true if coroutine is suspended, false if element was poped
+     */
+    bool await_suspend(std::coroutine_handle<> handle) {
+      this->handle = handle;
+      if (deque.popWaiters.Suspend(this, [this] { return deque.PopCells(1, &data) != 0; }))
+        return true;
+      deque.AfterPop();
+      return false;
+    }
+
+    /**
+     * Get poped element function. Exception thrown while element was poped by producer is rethrown here.
+     * @return poped element
+     */
+    T await_resume(void) {
+      if (error)
+        std::rethrow_exception(error);
+      return std::move(*data);
+    }
+  };
+
+  /**
+   * @brief Push back awaiter class.
+   *
+   * Suspended producer is resumed by consumer, which pushes awaiter element after freeing cell.
+   */
+  class push_awaiter_t : public coroutine_waiters_t::waiter_t {
+  private:
+    friend class concurrent_deque_t;
+
+    concurrent_deque_t &deque;  ///< deque to push to
+    T data;                     ///< element to push
+    std::exception_ptr error;   ///< exception thrown while element was pushed for suspended producer
+
+  public:
+    /**
+     * Constructor with deque and element function.
+     * @param[in] deque deque to push to
+     * @param[in] data element to push
+     */
+    push_awaiter_t(concurrent_deque_t &deque, T &&data) : deque(deque), data(std::move(data)) {
+    }
+
+    /**
+     * Try to push without suspension function.
+     * @return true if element was pushed, false - otherwise
+     */
+    bool await_ready(void) {
+      return deque.TryEmplaceBack(std::move(data));
+    }
+
+    /**
+     * Register coroutine in deque function.
+     * @param[in] handle awaiting coroutine
+     * @return true if coroutine is suspended, false if element was pushed
+     */
+    bool await_suspend(std::coroutine_handle<> handle) {
+      this->handle = handle;
+      if (deque.pushWaiters.Suspend(this, [this] { return deque.TryEmplaceCell(std::move(data)); }))
+        return true;
+      deque.AfterPush();
+      return false;
+    }
+
+    /**
+     * Finish push function. Exception thrown while element was pushed by consumer is rethrown here.
+     */
+    void await_resume(void) {
+      if (error)
+        std::rethrow_exception(error);
+    }
+  };
+
+  /**
+   * Pop elements for suspended consumers and resume them function.
+   * Exception of element move is passed to its consumer, so calling producer is not affected.
+   * @return true if any consumer was resumed, false - otherwise
+   */
+  bool ResumePopWaiters(void) {
+    return popWaiters.Resume([this](coroutine_waiters_t::waiter_t *waiter) {
+      pop_awaiter_t *awaiter = static_cast<pop_awaiter_t *>(waiter);
+      try {
+        return PopCells(1, &awaiter->data) != 0;
+      }
+      catch (...) {
+        awaiter->error = std::current_exception();
+        return true;
+      }
+    });
+  }
+
+  /**
+   * Push elements of suspended producers and resume them function.
+   * Exception of element construction is passed to its producer, so calling consumer keeps poped element.
+   * @return true if any producer was resumed, false - otherwise
+   */
+  bool ResumePushWaiters(void) {
+    return pushWaiters.Resume([this](coroutine_waiters_t::waiter_t *waiter) {
+      push_awaiter_t *awaiter = static_cast<push_awaiter_t *>(waiter);
+      try {
+        return TryEmplaceCell(std::move(awaiter->data));
+      }
+      catch (...) {
+        awaiter->error = std::current_exception();
+        return true;
+      }
+    });
+  }
+#endif
+
+  /**
+   * Notify consumers after push function.
+   * Elements poped for suspended consumers free cells for suspended producers, so queues are resumed in turn.
+   */
+  void AfterPush(void) {
+    notEmpty.Notify();
+#ifdef __cpp_impl_coroutine
+    while (ResumePopWaiters() && ResumePushWaiters())
+      notEmpty.Notify();
+#endif
+  }
+
+  /**
+   * Notify producers after pop function.
+   */
+  void AfterPop(void) {
+#ifdef __cpp_impl_coroutine
+    while (ResumePushWaiters()) {
+      notEmpty.Notify();
+      if (!ResumePopWaiters())
+        break;
+    }
+#endif
+  }
+
+public:
+  /**
+   * Constructor with capacity. Available only for static strategy.
+   * @param[in] capacity maximal number of elements, rounded up to power of two
+   */
+  explicit concurrent_deque_t(size_t capacity) {
+    InitCells(capacity);
+  }
+
+  /**
+   * Constructor with capacity and strategy function.
+   * @param[in] capacity maximal number of elements, rounded up to power of two
+   * @param[in] strategy allocation strategy
+   */
+  concurrent_deque_t(size_t capacity, std::shared_ptr<alloc_strategy_t> const &strategy) :
+    allocator(strategy) {
+    InitCells(capacity);
+  }
+
+  /**
+   * Deleted copy constructor.
+   */
+  concurrent_deque_t(concurrent_deque_t const &) = delete;
+
+  /**
+   * Deleted copy operator =.
+   */
+  concurrent_deque_t &operator=(concurrent_deque_t const &) = delete;
+
+  /**
+   * Destructor.
+   */
+  ~concurrent_deque_t(void) {
+    for (size_t i = 0; i <= mask; i++)
+      if (cells[i].hasData)
+        cells[i].Data()->~T();
+    allocator.deallocArray(cells, mask + 1);
+  }
+
+  /**
+   * Try to construct element back in place function.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   * @return true if element was pushed, false if deque is full
+   */
+  template <typename... Args>
+  bool TryEmplaceBack(Args&&... constructorArgs) {
+    if (!TryEmplaceCell(std::forward<Args>(constructorArgs)...))
+      return false;
+    AfterPush();
+    return true;
+  }
+
+  /**
+   * Try to push element back function.
+   * @param[in] data data to push
+   * @return true if element was pushed, false if deque is full
+   */
+  bool TryPushBack(T const &data) {
+    return TryEmplaceBack(data);
+  }
+
+  /**
+   * Try to push element back with move function.
+   * @param[in] data data to push
+   * @return true if element was pushed, false if deque is full
+   */
+  bool TryPushBack(T &&data) {
+    return TryEmplaceBack(std::move(data));
+  }
+
+  /**
+   * Push element back function.
+   * @param[in] data data to push
+   */
+  void PushBack(T const &data) {
+    if (!TryEmplaceBack(data))
+      throw std::exception("Full list");
+  }
+
+  /**
+   * Push element back with move function.
+   * @param[in] data data to push
+   */
+  void PushBack(T &&data) {
+    if (!TryEmplaceBack(std::move(data)))
+      throw std::exception("Full list");
+  }
+
+  /**
+   * Try to pop element front function.
+   * @param[out] data poped element
+   * @return true if element was poped, false if deque is empty
+   */
+  bool TryPopFront(T &data) {
+    size_t pos;
+    cell_t *cell = AcquirePop(pos);
+    if (cell == nullptr)
+      return false;
+    try {
+      data = std::move(*cell->Data());
+    }
+    catch (...) {
+      ReleasePop(cell, pos);
+      throw;
+    }
+    ReleasePop(cell, pos);
+    AfterPop();
+    return true;
+  }
+
+  /**
+   * Pop element front function.
+   * @return poped element
+   */
+  T PopFront(void) {
+    size_t pos;
+    cell_t *cell = AcquirePop(pos);
+    if (cell == nullptr)
+      throw std::exception("Empty list");
+    try {
+      T data = std::move(*cell->Data());
+      ReleasePop(cell, pos);
+      cell = nullptr;
+      AfterPop();
+      return data;
+    }
+    catch (...) {
+      if (cell != nullptr)
+        ReleasePop(cell, pos);
+      throw;
+    }
+  }
+
+  /**
+   * Pop several elements front function.
+   * Every element is acquired separately, so elements of several consumers may interleave.
+   * @tparam OutputIt output iterator type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @return number of poped elements
+   */
+  template <typename OutputIt>
+  size_t PopFront(size_t count, OutputIt out) {
+    size_t popedCount = PopCells(count, out);
+    if (popedCount != 0)
+      AfterPop();
+    return popedCount;
+  }
+
+  /**
+   * Wait for element and pop it front function.
+   * @return poped element
+   */
+  T WaitPopFront(void) {
+    std::optional<T> data;
+    notEmpty.Wait([this, &data] {
+      return PopFront(1, &data) != 0;
+    });
+    return std::move(*data);
+  }
+
+  /**
+   * Wait for element and pop it front with timeout function.
+   * @tparam Rep timeout representation type
+   * @tparam Period timeout period type
+   * @param[out] data poped element
+   * @param[in] timeout maximal time to wait
+   * @return true if element was poped, false on timeout
+   */
+  template <typename Rep, typename Period>
+  bool WaitPopFront(T &data, std::chrono::duration<Rep, Period> const &timeout) {
+    event_count_t::clock_t::time_point deadline = event_count_t::Deadline(timeout);
+    return notEmpty.Wait([this, &data] {
+      return TryPopFront(data);
+    }, &deadline);
+  }
+
+  /**
+   * Wait for element and pop it front with timeout function.
+   * @tparam Rep timeout representation type
+   * @tparam Period timeout period type
+   * @param[in] timeout maximal time to wait
+   * @return poped element, empty on timeout
+   */
+  template <typename Rep, typename Period>
+  std::optional<T> WaitPopFront(std::chrono::duration<Rep, Period> const &timeout) {
+    std::optional<T> data;
+    event_count_t::clock_t::time_point deadline = event_count_t::Deadline(timeout);
+    notEmpty.Wait([this, &data] {
+      return PopFront(1, &data) != 0;
+    }, &deadline);
+    return data;
+  }
+
+  /**
+   * Wait for elements and pop several of them front with timeout function.
+   * Waits until at least one element is available, then pops available elements without waiting.
+   * @tparam OutputIt output iterator type
+   * @tparam Rep timeout representation type
+   * @tparam Period timeout period type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @param[in] timeout maximal time to wait
+   * @return number of poped elements, 0 on timeout
+   */
+  template <typename OutputIt, typename Rep, typename Period>
+  size_t WaitPopFrontN(size_t count, OutputIt out, std::chrono::duration<Rep, Period> const &timeout) {
+    size_t popedCount = 0;
+    event_count_t::clock_t::time_point deadline = event_count_t::Deadline(timeout);
+    notEmpty.Wait([this, count, &out, &popedCount] {
+      popedCount = PopFront(count, out);
+      return popedCount != 0 || count == 0;
+    }, &deadline);
+    return popedCount;
+  }
+
+#ifdef __cpp_impl_coroutine
+  /**
+   * Await element and pop it front function.
+   * Coroutine is resumed on producer thread, and deque must outlive it.
+   * @return awaiter which gives poped element
+   */
+  pop_awaiter_t AsyncPopFront(void) {
+    return pop_awaiter_t(*this);
+  }
+
+  /**
+   * Await free cell and push element back function.
+   * Coroutine is resumed on consumer thread, and deque must outlive it.
+   * @param[in] data data to push
+   * @return awaiter which finishes when element is pushed
+   */
+  push_awaiter_t AsyncPushBack(T const &data) {
+    return push_awaiter_t(*this, T(data));
+  }
+
+  /**
+   * Await free cell and push element back with move function.
+   * Coroutine is resumed on consumer thread, and deque must outlive it.
+   * @param[in] data data to push
+   * @return awaiter which finishes when element is pushed
+   */
+  push_awaiter_t AsyncPushBack(T &&data) {
+    return push_awaiter_t(*this, std::move(data));
+  }
+#endif
+
+  /**
+   * Is empty check function. Result may be outdated when it is returned.
+   * @return true if deque is empty, false - otherwise
+   */
+  bool IsEmpty(void) const {
+    return popPos.load(std::memory_order_acquire) >= pushPos.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Get capacity function.
+   * @return maximal number of elements
+   */
+  size_t Capacity(void) const {
+    return mask + 1;
+  }
+};
+
+#endif /* __CONCURRENT_DEQUE_H_INCLUDED */
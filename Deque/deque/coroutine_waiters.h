@@ -0,0 +1,151 @@
+/**
+ * @file
+ * @brief Coroutine waiters header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains queue of suspended coroutines which are resumed directly by the thread publishing data,
+ * enabled when compiler supports C++20 coroutines
+ */
+
+#pragma once
+
+#ifndef __COROUTINE_WAITERS_H_INCLUDED
+#define __COROUTINE_WAITERS_H_INCLUDED
+
+#include <atomic>
+#include <mutex>
+
+#ifdef __cpp_impl_coroutine
+
+#include <coroutine>
+
+/**
+ * @brief Coroutine waiters queue class.
+ *
+ * Awaiters register themselves and check condition under lock; thread which changes deque state
+ * satisfies conditions of registered awaiters in FIFO order under the same lock and resumes them after unlock.
+ * So condition of one queue is never checked concurrently, and resuming thread is not switched like on thread wake up.
+ * Checking queue without awaiters costs one fence and one load.
+ */
+class coroutine_waiters_t {
+public:
+  /**
+   * @brief Registered awaiter struct.
+   *
+   * Base of deque awaiters, linked into queue while coroutine is suspended.
+   */
+  struct waiter_t {
+    std::coroutine_handle<> handle;  ///< suspended coroutine
+    waiter_t *next = nullptr;        ///< next awaiter in queue
+  };
+
+private:
+  std::mutex mutex;               ///< queue mutex
+  std::atomic<size_t> count;      ///< number of registered awaiters
+  waiter_t
+    *first = nullptr,             ///< oldest awaiter
+    *last = nullptr;              ///< newest awaiter
+
+  /**
+   * Remove oldest awaiter function. Called under lock.
+   * @return removed awaiter
+   */
+  waiter_t *Dequeue(void) {
+    waiter_t *waiter = first;
+    first = waiter->next;
+    if (first == nullptr)
+      last = nullptr;
+    waiter->next = nullptr;
+    count.fetch_sub(1, std::memory_order_relaxed);
+    return waiter;
+  }
+
+  /**
+   * Resume list of removed awaiters function. Called without lock.
+   * @param[in] ready first awaiter of list
+   */
+  static void ResumeAll(waiter_t *ready) {
+    while (ready != nullptr) {
+      // awaiter lives in suspended coroutine frame, so it is read before resume
+      waiter_t *next = ready->next;
+      ready->handle.resume();
+      ready = next;
+    }
+  }
+
+public:
+  /**
+   * Default constructor.
+   */
+  coroutine_waiters_t(void) : count(0) {
+  }
+
+  /**
+   * Deleted copy constructor.
+   */
+  coroutine_waiters_t(coroutine_waiters_t const &) = delete;
+
+  /**
+   * Deleted copy operator =.
+   */
+  coroutine_waiters_t &operator=(coroutine_waiters_t const &) = delete;
+
+  /**
+   * Register awaiter unless condition is satisfied function.
+   * @tparam TryFn condition type, called without arguments, returns true on success
+   * @param[in] waiter awaiter with handle of coroutine to suspend
+   * @param[in] tryFn condition, usually try to pop
+   * @return true if coroutine has to be suspended, false if condition was satisfied
+   */
+  template <typename TryFn>
+  bool Suspend(waiter_t *waiter, TryFn tryFn) {
+    std::lock_guard<std::mutex> lock(mutex);
+    count.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (tryFn()) {
+      count.fetch_sub(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (last == nullptr)
+      first = waiter;
+    else
+      last->next = waiter;
+    last = waiter;
+    return true;
+  }
+
+  /**
+   * Satisfy conditions of oldest awaiters and resume them function.
+   * Stops on first awaiter whose condition is not satisfied.
+   * If condition throws, awaiters satisfied before are resumed and exception is rethrown.
+   * @tparam TryFn condition type, called with 'waiter_t *', returns true on success
+   * @param[in] tryFn condition for awaiter, usually pop element into it
+   * @return true if any awaiter was resumed, false - otherwise
+   */
+  template <typename TryFn>
+  bool Resume(TryFn tryFn) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (count.load(std::memory_order_relaxed) == 0)
+      return false;
+    waiter_t *ready = nullptr, **readyLast = &ready;
+    try {
+      std::lock_guard<std::mutex> lock(mutex);
+      while (first != nullptr && tryFn(first)) {
+        *readyLast = Dequeue();
+        readyLast = &(*readyLast)->next;
+      }
+    } catch (...) {
+      // already satisfied awaiters are not in queue anymore, so they are resumed before rethrow
+      ResumeAll(ready);
+      throw;
+    }
+    if (ready == nullptr)
+      return false;
+    ResumeAll(ready);
+    return true;
+  }
+};
+
+#endif /* __cpp_impl_coroutine */
+
+#endif /* __COROUTINE_WAITERS_H_INCLUDED */
@@ -11,35 +11,31 @@
 #ifndef __DEQUE_H_INCLUDED
 #define __DEQUE_H_INCLUDED
 
+#include <algorithm>
+#include <cstdint>
 #include <exception>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "../allocator/allocator.h"
+#include "iterator_checks.h"
 
 /**
- * @brief Template deque class.
- * @tparam T deque elements type
- *
- * Deque on doubly linked list with allocators.
+ * @brief Deque implementation namespace.
  */
-template <typename T>
-class deque_t {
-  /**
-   * Friend operator<< for deque and output.
-   * @tparam T1 deque elements type
-   * @param[in] stream output stream
-   * @param[in] deq deque to output
-   * @return reference to stream
-   */
-  template <typename T1>
-  friend std::ostream &operator<<(std::ostream &stream, deque_t<T1> const &deq);
-
-private:
+namespace deque_detail {
   /**
    * @brief Deque node struct.
+   * @tparam T deque elements type
    *
    * Doubly linked list node struct with 'T' data type.
    */
+  template <typename T>
   struct node_t {
     node_t
       *next,  ///< pointer to next list element
@@ -47,130 +43,681 @@ private:
     T data;   ///< data
 
     /**
-     * Constructor by params.
-     * @param[in] newData node data
+     * Constructor by params. Data is constructed in place.
+     * @tparam Args data constructor argument types
      * @param[in] newPrev previous node
      * @param[in] newNext next node
+     * @param[in] dataArgs data constructor arguments
      */
-    node_t(T const &newData, node_t *newPrev, node_t *newNext) :
-      data(newData), prev(newPrev), next(newNext) {
+    template <typename... Args>
+    node_t(node_t *newPrev, node_t *newNext, Args&&... dataArgs) :
+      next(newNext), prev(newPrev), data(std::forward<Args>(dataArgs)...) {
     }
+  };
+
+  /**
+   * @brief Inline nodes storage class.
+   * @tparam Node node type
+   * @tparam Count number of nodes
+   *
+   * Raw storage for nodes inside deque object.
+   */
+  template <typename Node, size_t Count>
+  class inline_nodes_t {
+  private:
+    alignas(Node) unsigned char storage[sizeof(Node) * Count];  ///< nodes storage
 
+  protected:
     /**
-     * Constructor by params. Data with move.
-     * @param[in] newData node data
-     * @param[in] newPrev previous node
-     * @param[in] newNext next node
+     * Get inline node storage by index function.
+     * @param[in] index node index
+     * @return pointer to node storage
      */
-    node_t(T &&newData, node_t *newPrev, node_t *newNext) :
-      data(std::move(newData)), prev(newPrev), next(newNext) {
+    Node *InlineNode(size_t index) {
+      return reinterpret_cast<Node *>(storage) + index;
+    }
+
+    /**
+     * Check if node storage is inline function.
+     * @param[in] ptr pointer to node storage
+     * @return true if storage lies inside deque object, false if it is allocated from strategy
+     */
+    bool IsInline(void const *ptr) const {
+      return reinterpret_cast<uintptr_t>(ptr) - reinterpret_cast<uintptr_t>(storage) < sizeof(storage);
     }
   };
+
+  /**
+   * @brief Empty inline nodes storage class.
+   * @tparam Node node type
+   */
+  template <typename Node>
+  class inline_nodes_t<Node, 0> {
+  protected:
+    /**
+     * Get inline node storage by index function. There are no inline nodes.
+     * @param[in] index node index
+     * @return nullptr
+     */
+    Node *InlineNode(size_t index) {
+      return nullptr;
+    }
+
+    /**
+     * Check if node storage is inline function.
+     * @param[in] ptr pointer to node storage
+     * @return false
+     */
+    bool IsInline(void const *ptr) const {
+      return false;
+    }
+  };
+}
+
+/**
+ * @brief Template deque class.
+ * @tparam T deque elements type
+ * @tparam Strategy allocation strategy type, 'alloc_strategy_t' means runtime strategy
+ * @tparam InlineCapacity number of nodes stored inside deque object
+ *
+ * Deque on doubly linked list with allocators.
+ * With static strategy type deque is default constructible and strategy calls have no virtual dispatch,
+ * functions with strategy argument are available only with runtime strategy.
+ * First 'InlineCapacity' nodes are taken from storage inside deque object and never returned to strategy,
+ * so short deques make no strategy calls.
+ * Up to node cache size freed nodes are kept as spare and reused by pushes,
+ * so deque which pushes and pops at the same rate makes no strategy calls with any strategy.
+ */
+template <typename T, typename Strategy = alloc_strategy_t, size_t InlineCapacity = 0>
+class deque_t : private deque_detail::inline_nodes_t<deque_detail::node_t<T>, InlineCapacity> {
+private:
+  using node_t = deque_detail::node_t<T>;  ///< list node type
+
+  /**
+   * @brief Spare node storage struct.
+   *
+   * Link placed in raw memory of reserved node which is not in list.
+   */
+  struct spare_t {
+    spare_t *next;  ///< next spare node storage
+  };
+
+  static constexpr size_t bulkBatch = 256;  ///< maximal number of nodes allocated or freed by one strategy call
+  static constexpr size_t inputBatch = 8;   ///< first batch size for ranges of unknown length
+
+public:
+  static constexpr size_t defaultNodeCache = 16;  ///< default number of freed nodes kept as spare
+
+private:
+
   node_t
     *start,                              ///< list beginning
     *tail;                               ///< list end
+  size_t size;                           ///< number of elements
+  spare_t *spare;                        ///< spare nodes storage list
+  size_t
+    spareCount,                          ///< number of spare nodes
+    reserved,                            ///< number of nodes kept allocated on pops
+    cacheLimit;                          ///< number of spare nodes kept on pops regardless of reservation
 
-  single_allocator_t<node_t> allocator;  ///< allocator for nodes
+  single_allocator_t<node_t, Strategy> allocator;  ///< allocator for nodes
 
   /**
    * Free deque node list function.
+   * Nodes are returned to strategy with batches, inline nodes become spare.
    * @param[in] begin list begin
-   * @param[in] allocator list allocator
    */
-  static void FreeList(node_t *begin, single_allocator_t<node_t> &allocator) {
-    for (node_t *node = begin; node != nullptr; ) {
-      node_t *next = node->next;
+  void FreeList(node_t *begin) {
+    node_t *nodes[bulkBatch];
+    while (begin != nullptr) {
+      size_t batch = 0;
+      while (batch < bulkBatch && begin != nullptr) {
+        node_t *node = begin;
+        begin = begin->next;
+        node->~node_t();
+        if (this->IsInline(node))
+          PushSpare(node);
+        else
+          nodes[batch++] = node;
+      }
+      if (batch != 0)
+        allocator.deallocRaw(nodes, batch);
+    }
+  }
+
+  /**
+   * Put all inline nodes storage to empty spare list function.
+   */
+  void InitInline(void) {
+    for (size_t i = InlineCapacity; i > 0; i--)
+      PushSpare(this->InlineNode(i - 1));
+  }
+
+  /**
+   * Put node storage to spare list function.
+   * @param[in] memory node storage without constructed node
+   */
+  void PushSpare(void *memory) {
+    spare = new (memory) spare_t{spare};
+    spareCount++;
+  }
+
+  /**
+   * Take node storage from spare list function. Spare list must be not empty.
+   * @return node storage without constructed node
+   */
+  void *PopSpare(void) {
+    spare_t *memory = spare;
+    spare = spare->next;
+    spareCount--;
+    return memory;
+  }
+
+  /**
+   * Return spare nodes to strategy function. Inline nodes stay spare.
+   * @param[in] limit capacity to keep spare nodes for
+   */
+  void FreeSpare(size_t limit = 0) {
+    node_t *nodes[bulkBatch];
+    spare_t *kept = nullptr;
+    size_t keptCount = 0;
+    while (spareCount != 0) {
+      size_t batch = 0;
+      while (batch < bulkBatch && spareCount != 0) {
+        void *memory = PopSpare();
+        if (this->IsInline(memory) || size + keptCount < limit) {
+          kept = new (memory) spare_t{kept};
+          keptCount++;
+        }
+        else
+          nodes[batch++] = static_cast<node_t *>(memory);
+      }
+      if (batch != 0)
+        allocator.deallocRaw(nodes, batch);
+    }
+    spare = kept;
+    spareCount = keptCount;
+  }
+
+  /**
+   * Free all nodes and spare nodes function.
+   * If elements need no destruction and deque is the only user of strategy,
+   * strategy memory is released at once without freeing every node.
+   * Inline nodes become spare.
+   */
+  void FreeAll(void) {
+    if (!std::is_trivially_destructible<T>::value || !allocator.release()) {
+      FreeList(start);
+      FreeSpare();
+    }
+    ResetNodes();
+  }
+
+  /**
+   * Forget all nodes and spare nodes after their memory is freed function. Inline nodes become spare.
+   */
+  void ResetNodes(void) {
+    start = nullptr;
+    tail = nullptr;
+    size = 0;
+    spare = nullptr;
+    spareCount = 0;
+    InitInline();
+  }
+
+  /**
+   * Fill empty deque spare list up to reservation and node cache function.
+   * Used after strategy memory is released, allocation failure leaves spare list shorter without exception.
+   */
+  void RefillSpare(void) {
+    node_t *nodes[bulkBatch];
+    size_t limit = std::max(reserved, cacheLimit);
+    try {
+      while (spareCount < limit) {
+        size_t batch = std::min(limit - spareCount, bulkBatch);
+        allocator.allocRaw(batch, nodes);
+        for (size_t i = 0; i < batch; i++)
+          PushSpare(nodes[i]);
+      }
+    }
+    catch (...) {
+      // spare nodes are only cache, so deque stays valid without them
+    }
+  }
+
+  /**
+   * Allocate and construct node function. Spare node storage is used first.
+   * @tparam Args node constructor argument types
+   * @param[in] constructorArgs node constructor arguments
+   * @return constructed node
+   */
+  template <typename... Args>
+  node_t *AllocNode(Args&&... constructorArgs) {
+    if (spare == nullptr)
+      return allocator.alloc(std::forward<Args>(constructorArgs)...);
+    void *memory = PopSpare();
+    try {
+      return new (memory) node_t(std::forward<Args>(constructorArgs)...);
+    }
+    catch (...) {
+      PushSpare(memory);
+      throw;
+    }
+  }
+
+  /**
+   * Check if freed node storage is kept as spare function.
+   * Storage is kept if it is inline, while deque capacity is below reserved or while node cache is not full.
+   * @param[in] memory node storage
+   * @return true if storage is kept, false if it is returned to strategy
+   */
+  bool KeepSpare(void const *memory) const {
+    return this->IsInline(memory) || size + spareCount < reserved || spareCount < cacheLimit;
+  }
+
+  /**
+   * Destroy and free node function. Node storage is kept as spare if 'KeepSpare' allows.
+   * @param[in] node node to free
+   */
+  void FreeNode(node_t *node) {
+    if (!KeepSpare(node)) {
       allocator.dealloc(node);
-      node = next;
+      return;
+    }
+    node->~node_t();
+    PushSpare(node);
+  }
+
+  /**
+   * Get storage for several nodes without construction function. Spare node storage is used first.
+   * @param[in] count number of nodes
+   * @param[out] nodes array to store pointers to nodes storage
+   */
+  void AcquireNodes(size_t count, node_t **nodes) {
+    size_t fromSpare = std::min(count, spareCount);
+    for (size_t i = 0; i < fromSpare; i++)
+      nodes[i] = static_cast<node_t *>(PopSpare());
+    if (fromSpare == count)
+      return;
+    try {
+      allocator.allocRaw(count - fromSpare, nodes + fromSpare);
+    }
+    catch (...) {
+      for (size_t i = 0; i < fromSpare; i++)
+        PushSpare(nodes[i]);
+      throw;
+    }
+  }
+
+  /**
+   * Free storage of several destroyed nodes function.
+   * Nodes storage is kept as spare if 'KeepSpare' allows, rest is returned to strategy with one call.
+   * @param[in] nodes array of pointers to nodes storage
+   * @param[in] count number of nodes
+   */
+  void ReleaseNodes(node_t **nodes, size_t count) {
+    size_t freed = 0;
+    for (size_t i = 0; i < count; i++)
+      if (KeepSpare(nodes[i]))
+        PushSpare(nodes[i]);
+      else
+        nodes[freed++] = nodes[i];
+    if (freed != 0)
+      allocator.deallocRaw(nodes, freed);
+  }
+
+  /**
+   * Take nodes of another deque with the same strategy function. Deque must be empty.
+   * Nodes allocated from strategy are taken without copying, elements of inline nodes are moved to own nodes.
+   * If element move throws, taken elements are destroyed and both deques stay empty.
+   * @param[in] rhs deque to take nodes from
+   */
+  void TakeNodes(deque_t &rhs) {
+    start = rhs.start;
+    tail = rhs.tail;
+    size = rhs.size;
+    reserved = rhs.reserved;
+    rhs.start = nullptr;
+    rhs.tail = nullptr;
+    rhs.size = 0;
+    rhs.reserved = 0;
+    if constexpr (InlineCapacity == 0) {
+      spare = rhs.spare;
+      spareCount = rhs.spareCount;
+      rhs.spare = nullptr;
+      rhs.spareCount = 0;
+    }
+    else {
+      while (rhs.spareCount != 0) {
+        void *memory = rhs.PopSpare();
+        if (!rhs.IsInline(memory))
+          PushSpare(memory);
+      }
+      try {
+        for (node_t *node = start; node != nullptr; node = node->next)
+          if (rhs.IsInline(node)) {
+            void *memory = PopSpare();
+            node_t *moved;
+            try {
+              moved = new (memory) node_t(node->prev, node->next, std::move(node->data));
+            }
+            catch (...) {
+              PushSpare(memory);
+              throw;
+            }
+            node->~node_t();
+            (moved->prev == nullptr ? start : moved->prev->next) = moved;
+            (moved->next == nullptr ? tail : moved->next->prev) = moved;
+            node = moved;
+          }
+      }
+      catch (...) {
+        size = 0;
+        while (start != nullptr) {
+          node_t *node = start;
+          start = start->next;
+          if (rhs.IsInline(node))
+            node->~node_t();
+          else
+            FreeNode(node);
+        }
+        tail = nullptr;
+        rhs.InitInline();
+        throw;
+      }
+      rhs.InitInline();
     }
   }
 
   /**
    * Copy deque node list function.
-   * @param[in] beginToCopy list to copy begin
+   * Deque must be empty, nodes are allocated with batches.
+   * @param[in] lhs deque to copy
    */
-  void CopyList(node_t const *beginToCopy) {
-    if (beginToCopy == nullptr) {
-      start = nullptr;
-      tail = nullptr;
+  void CopyList(deque_t const &lhs) {
+    node_t *begin, *end;
+    size = BuildList(lhs.begin(), lhs.end(), begin, end, lhs.size);
+    start = begin;
+    tail = end;
+  }
+
+  /**
+   * Copy elements of deque with equal allocator reusing nodes function.
+   * Existing elements are assigned, missing nodes are built with batches, extra nodes are freed or kept as spare.
+   * @param[in] lhs deque to copy
+   */
+  void AssignList(deque_t const &lhs) {
+    node_t *node = start;
+    node_t const *src = lhs.start;
+    for (; node != nullptr && src != nullptr; node = node->next, src = src->next)
+      node->data = src->data;
+    if (src != nullptr) {
+      node_t *begin, *end;
+      size += BuildList(const_iterator_t(src, &lhs), lhs.end(), begin, end, lhs.size - size);
+      begin->prev = tail;
+      if (tail == nullptr)
+        start = begin;
+      else
+        tail->next = begin;
+      tail = end;
       return;
     }
-    start = allocator.alloc(*beginToCopy);
-    node_t *prev = start;
-    for (node_t const *node = beginToCopy->next; node != nullptr; node = node->next, prev = prev->next) {
-      node_t *tmp = allocator.alloc(node->data, prev, nullptr);
-      prev->next = tmp;
+    if (node == nullptr)
+      return;
+    tail = node->prev;
+    if (tail == nullptr)
+      start = nullptr;
+    else
+      tail->next = nullptr;
+    node_t *nodes[bulkBatch];
+    while (node != nullptr) {
+      size_t batch = 0;
+      for (; batch < bulkBatch && node != nullptr; batch++) {
+        nodes[batch] = node;
+        node = node->next;
+        nodes[batch]->~node_t();
+        size--;
+      }
+      ReleaseNodes(nodes, batch);
+    }
+  }
+
+  /**
+   * Build detached node list from range function.
+   * Nodes are allocated with batches, list is freed if exception is thrown.
+   * Batches for ranges of unknown length start small and double up to 'bulkBatch',
+   * so unused nodes of last batch never exceed number of built ones.
+   * @tparam InputIt range iterator type
+   * @param[in] first range begin
+   * @param[in] last range end
+   * @param[out] begin built list begin, nullptr for empty range
+   * @param[out] end built list end
+   * @param[in] rangeSize number of range elements if it is known, otherwise it is computed for forward iterators
+   * @return number of nodes in built list
+   */
+  template <typename InputIt>
+  size_t BuildList(InputIt first, InputIt last, node_t *&begin, node_t *&end, std::optional<size_t> rangeSize = std::nullopt) {
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    bool isForward = rangeSize.has_value() || std::is_base_of<std::forward_iterator_tag, category>::value;
+    size_t
+      left = rangeSize ? *rangeSize : isForward ? static_cast<size_t>(std::distance(first, last)) : inputBatch,
+      count = 0;
+    node_t *nodes[bulkBatch];
+    begin = nullptr;
+    end = nullptr;
+    while (first != last) {
+      size_t batch = std::min(left, bulkBatch), built = 0;
+      AcquireNodes(batch, nodes);
+      try {
+        for (; built < batch && first != last; built++, ++first) {
+          new (nodes[built]) node_t(end, nullptr, *first);
+          if (end == nullptr)
+            begin = nodes[built];
+          else
+            end->next = nodes[built];
+          end = nodes[built];
+        }
+      }
+      catch (...) {
+        ReleaseNodes(nodes + built, batch - built);
+        FreeList(begin);
+        throw;
+      }
+      if (built < batch)
+        ReleaseNodes(nodes + built, batch - built);
+      count += built;
+      if (isForward)
+        left -= built;
+      else
+        left = std::min(left * 2, bulkBatch);
+    }
+    return count;
+  }
+
+  /**
+   * Remove last node function. Deque must be not empty.
+   */
+  void EraseBack(void) {
+    node_t *tmp = tail->prev;
+    size--;
+    FreeNode(tail);
+    tail = tmp;
+    if (tmp == nullptr)
+      start = nullptr;
+    else
+      tail->next = nullptr;
+  }
+
+  /**
+   * Remove first node function. Deque must be not empty.
+   */
+  void EraseFront(void) {
+    node_t *tmp = start->next;
+    size--;
+    FreeNode(start);
+    start = tmp;
+    if (tmp == nullptr)
+      tail = nullptr;
+    else
+      start->prev = nullptr;
+  }
+
+  /**
+   * Link detached node list before node function.
+   * @param[in] next node to link list before, nullptr for list end
+   * @param[in] begin linked list begin
+   * @param[in] end linked list end
+   * @param[in] count number of nodes in linked list
+   */
+  void LinkBefore(node_t *next, node_t *begin, node_t *end, size_t count) {
+    node_t *prev = next == nullptr ? tail : next->prev;
+    begin->prev = prev;
+    end->next = next;
+    (prev == nullptr ? start : prev->next) = begin;
+    (next == nullptr ? tail : next->prev) = end;
+    size += count;
+  }
+
+  /**
+   * Move elements of inline nodes from node to list end into nodes allocated from strategy function.
+   * List stays valid if exception is thrown, so after success the list part may be linked to deque with the same strategy.
+   * @param[in] begin first node of list part
+   * @return node which holds first element of list part
+   */
+  node_t *DetachInline(node_t *begin) {
+    if constexpr (InlineCapacity != 0)
+      for (node_t *node = begin; node != nullptr; node = node->next)
+        if (this->IsInline(node)) {
+          node_t *moved = allocator.alloc(node->prev, node->next, std::move(node->data));
+          node->~node_t();
+          PushSpare(node);
+          (moved->prev == nullptr ? start : moved->prev->next) = moved;
+          (moved->next == nullptr ? tail : moved->next->prev) = moved;
+          if (node == begin)
+            begin = moved;
+          node = moved;
+        }
+    return begin;
+  }
+
+  /**
+   * Count nodes from node to list end function.
+   * List is walked from node in both directions, so number of steps is the smallest of parts sizes.
+   * @param[in] node first counted node
+   * @return number of nodes
+   */
+  size_t CountToEnd(node_t const *node) const {
+    node_t const *back = node->prev;
+    for (size_t steps = 0;; steps++) {
+      if (node == nullptr)
+        return steps;
+      if (back == nullptr)
+        return size - steps;
+      node = node->next;
+      back = back->prev;
     }
-    tail = prev;
-    prev->next = nullptr;
   }
 
   /**
    * @brief Deque iterator class.
+   * @tparam IsConst constant iterator flag
    *
-   * Class for deque iteration with data modification ability.
+   * Bidirectional iterator over list nodes, end iterator is decremented to last element.
+   * Iterators are invalidated only by removal of iterated element.
+   * Dereference of end iterator and moving over deque bounds throw only with checked iterators (see DEQUE_CHECKED_ITERATORS).
    */
-  class iterator_t {
+  template <bool IsConst>
+  class basic_iterator_t {
+    template <bool> friend class basic_iterator_t;
+    friend class deque_t;
+
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;                   ///< iterator category
+    using value_type = T;                                                        ///< element type
+    using difference_type = std::ptrdiff_t;                                      ///< iterators distance type
+    using pointer = typename std::conditional<IsConst, T const *, T *>::type;    ///< element pointer type
+    using reference = typename std::conditional<IsConst, T const &, T &>::type;  ///< element reference type
+
   private:
-    node_t *node;  ///< current node
+    using node_ptr_t = typename std::conditional<IsConst, node_t const *, node_t *>::type;     ///< node pointer type
+    using deque_ptr_t = typename std::conditional<IsConst, deque_t const *, deque_t *>::type;  ///< iterated deque pointer type
+
+    node_ptr_t node;  ///< current node, nullptr for end iterator
+    deque_ptr_t deq;  ///< iterated deque
+
   public:
     /**
-     * Constructor by node.
-     * @param[in] n node for iterator
+     * Default constructor. Iterator is singular.
      */
-    iterator_t(node_t *n) : node(n) {
+    basic_iterator_t(void) : node(nullptr), deq(nullptr) {
     }
 
     /**
-     * Deleted default constructor.
-     */
-    iterator_t(void) = delete;
-
-    /**
-     * Default copy constructor.
-     * @param[in] lhs iterator to copy
+     * Constructor by node and deque.
+     * @param[in] n node for iterator
+     * @param[in] d deque for iterator
      */
-    iterator_t(iterator_t const &lhs) = default;
+    basic_iterator_t(node_ptr_t n, deque_ptr_t d) : node(n), deq(d) {
+    }
 
     /**
-     * Default move constructor.
-     * @param[in] rhs iterator to move
+     * Conversion constructor from modifying iterator to constant iterator.
+     * @tparam WasConst converted iterator constant flag
+     * @param[in] lhs iterator to convert
      */
-    iterator_t(iterator_t &&rhs) = default;
+    template <bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+    basic_iterator_t(basic_iterator_t<WasConst> const &lhs) : node(lhs.node), deq(lhs.deq) {
+    }
 
     /**
      * Equality operator.
+     * @tparam IsConst1 compared iterator constant flag
      * @param[in] lhs iterator to compare
      */
-    bool operator==(iterator_t const &lhs) {
+    template <bool IsConst1>
+    bool operator==(basic_iterator_t<IsConst1> const &lhs) const {
       return node == lhs.node;
     }
 
     /**
      * Inequality operator.
+     * @tparam IsConst1 compared iterator constant flag
      * @param[in] lhs iterator to compare
      */
-    bool operator!=(iterator_t const &lhs) {
+    template <bool IsConst1>
+    bool operator!=(basic_iterator_t<IsConst1> const &lhs) const {
       return node != lhs.node;
     }
 
     /**
      * Operator * to provide pointer semantics.
-     * @return data pointer
+     * @return data reference
      */
-    T &operator*(void) {
+    reference operator*(void) const {
+#if DEQUE_CHECKED_ITERATORS
       if (node == nullptr)
         throw std::exception("Try to use end iterator");
+#endif /* DEQUE_CHECKED_ITERATORS */
       return node->data;
     }
 
+    /**
+     * Operator -> to provide pointer semantics.
+     * @return data pointer
+     */
+    pointer operator->(void) const {
+      return &**this;
+    }
+
     /**
      * Prefix increment.
      * @return current iterator value
      */
-    iterator_t &operator++(void) {
+    basic_iterator_t &operator++(void) {
+#if DEQUE_CHECKED_ITERATORS
       if (node == nullptr)
         throw std::exception("Try to use end iterator");
+#endif /* DEQUE_CHECKED_ITERATORS */
       node = node->next;
       return *this;
     }
@@ -180,35 +727,78 @@ private:
      * @param[in] unusedInteger unused argument
      * @return previous iterator value
      */
-    iterator_t &operator++(int unusedInteger) {
-      if (node == nullptr)
-        throw std::exception("Try to use end iterator");
-      iterator_t tmp{*this};
-      node = node->next;
+    basic_iterator_t operator++(int unusedInteger) {
+      basic_iterator_t tmp{*this};
+      ++*this;
+      return tmp;
+    }
+
+    /**
+     * Prefix decrement.
+     * @return current iterator value
+     */
+    basic_iterator_t &operator--(void) {
+      node_ptr_t prev = node == nullptr ? deq->tail : node->prev;
+#if DEQUE_CHECKED_ITERATORS
+      if (prev == nullptr)
+        throw std::exception("Try to move before begin iterator");
+#endif /* DEQUE_CHECKED_ITERATORS */
+      node = prev;
+      return *this;
+    }
+
+    /**
+     * Postfix decrement.
+     * @param[in] unusedInteger unused argument
+     * @return previous iterator value
+     */
+    basic_iterator_t operator--(int unusedInteger) {
+      basic_iterator_t tmp{*this};
+      --*this;
       return tmp;
     }
   };
 
+  /**
+   * Constructor with allocator function.
+   * @param[in] nodeAllocator allocator for nodes
+   */
+  explicit deque_t(single_allocator_t<node_t, Strategy> const &nodeAllocator) :
+    start(nullptr), tail(nullptr), size(0), spare(nullptr), spareCount(0), reserved(0), cacheLimit(defaultNodeCache), allocator(nodeAllocator) {
+    InitInline();
+  }
+
 public:
+  using iterator_t = basic_iterator_t<false>;       ///< modifying iterator type
+  using const_iterator_t = basic_iterator_t<true>;  ///< constant iterator type
+
+  /**
+   * Default constructor. Available only for static strategy.
+   */
+  deque_t(void) :
+    start(nullptr), tail(nullptr), size(0), spare(nullptr), spareCount(0), reserved(0), cacheLimit(defaultNodeCache) {
+    InitInline();
+  }
+
   /**
    * Constructor with strategy function.
    * @param[in] strategy allocation strategy
    */
   deque_t(std::shared_ptr<alloc_strategy_t> const &strategy) :
-    start(nullptr), tail(nullptr), allocator(strategy) {
+    start(nullptr), tail(nullptr), size(0), spare(nullptr), spareCount(0), reserved(0), cacheLimit(defaultNodeCache),
+    allocator(strategy) {
+    InitInline();
   }
 
   /**
    * Copy constructor.
    * @param[in] lhs instance to copy
    */
-  deque_t(deque_t const &lhs) : allocator(lhs.allocator) {
-    if (lhs.start == nullptr) {
-      start = nullptr;
-      tail = nullptr;
-      return;
-    }
-    CopyList(lhs.start);
+  deque_t(deque_t const &lhs) :
+    start(nullptr), tail(nullptr), size(0), spare(nullptr), spareCount(0), reserved(0), cacheLimit(lhs.cacheLimit),
+    allocator(lhs.allocator) {
+    InitInline();
+    CopyList(lhs);
   }
 
   /**
@@ -217,28 +807,43 @@ public:
    * @param[in] strategy allocation strategy
    */
   deque_t(deque_t const &lhs, std::shared_ptr<alloc_strategy_t> const &strategy) :
+    start(nullptr), tail(nullptr), size(0), spare(nullptr), spareCount(0), reserved(0), cacheLimit(lhs.cacheLimit),
     allocator(strategy) {
-    CopyList(lhs.start);
+    InitInline();
+    CopyList(lhs);
   }
 
   /**
    * Move constructor.
+   * Elements of inline nodes are moved one by one, other nodes are taken without copying.
    * @param[in] rhs instance to copy
    */
   deque_t(deque_t &&rhs) :
-    start(rhs.start), tail(rhs.tail), allocator(std::move(rhs.allocator)) {
-    rhs.start = nullptr;
-    rhs.tail = nullptr;
+    start(nullptr), tail(nullptr), size(0), spare(nullptr), spareCount(0), reserved(0), cacheLimit(rhs.cacheLimit),
+    allocator(std::move(rhs.allocator)) {
+    InitInline();
+    TakeNodes(rhs);
   }
 
   /**
    * Copy operator =.
+   * With equal allocators existing nodes are reused and reservation is kept,
+   * otherwise nodes are freed and allocated from strategy of copied deque. Node cache size is copied.
    * @param[in] lhs instance to copy
    */
   void operator=(deque_t const &lhs) {
-    FreeList(start, allocator);
+    if (this == &lhs)
+      return;
+    if (allocator == lhs.allocator) {
+      SetNodeCache(lhs.cacheLimit);
+      AssignList(lhs);
+      return;
+    }
+    FreeAll();
+    reserved = 0;
+    cacheLimit = lhs.cacheLimit;
     allocator = lhs.allocator;
-    CopyList(lhs.start);
+    CopyList(lhs);
   }
 
   /**
@@ -247,41 +852,74 @@ public:
    * @param[in] strategy allocation strategy for deque
    */
   void Copy(deque_t const &lhs, std::shared_ptr<alloc_strategy_t> const &strategy) {
-    FreeList(start, allocator);
-    allocator = single_allocator_t<node_t>(strategy);
-    CopyList(lhs.start);
+    FreeAll();
+    reserved = 0;
+    cacheLimit = lhs.cacheLimit;
+    allocator = single_allocator_t<node_t, Strategy>(strategy);
+    CopyList(lhs);
   }
 
   /**
    * Move operator =.
+   * Elements of inline nodes are moved one by one, other nodes are taken without copying. Node cache size is taken too.
    * @param[in] rhs rValue instance to copy
    */
   void operator=(deque_t &&rhs) {
-    FreeList(start, allocator);
+    if (this == &rhs)
+      return;
+    FreeAll();
+    cacheLimit = rhs.cacheLimit;
     allocator = std::move(rhs.allocator);
-    start = rhs.start;
-    tail = rhs.tail;
-    rhs.tail = nullptr;
-    rhs.start = nullptr;
+    TakeNodes(rhs);
   }
 
   /**
    * Destructor.
    */
   ~deque_t(void) {
-    FreeList(start, allocator);
+    FreeAll();
   }
 
   /**
-   * Push element back function.
-   * @param[in] data data to push
+   * Construct element back in place function.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   * @return reference to constructed element
    */
-  void PushBack(T const &data) {
-    tail = allocator.alloc(data, tail, nullptr);
+  template <typename... Args>
+  T &EmplaceBack(Args&&... constructorArgs) {
+    tail = AllocNode(tail, nullptr, std::forward<Args>(constructorArgs)...);
+    size++;
     if (start == nullptr)
       start = tail;
     else
       tail->prev->next = tail;
+    return tail->data;
+  }
+
+  /**
+   * Construct element front in place function.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   * @return reference to constructed element
+   */
+  template <typename... Args>
+  T &EmplaceFront(Args&&... constructorArgs) {
+    start = AllocNode(nullptr, start, std::forward<Args>(constructorArgs)...);
+    size++;
+    if (tail == nullptr)
+      tail = start;
+    else
+      start->next->prev = start;
+    return start->data;
+  }
+
+  /**
+   * Push element back function.
+   * @param[in] data data to push
+   */
+  void PushBack(T const &data) {
+    EmplaceBack(data);
   }
 
   /**
@@ -289,11 +927,7 @@ public:
    * @param[in] data data to push
    */
   void PushBack(T &&data) {
-    tail = allocator.alloc(std::move(data), tail, nullptr);
-    if (start == nullptr)
-      start = tail;
-    else
-      tail->prev->next = tail;
+    EmplaceBack(std::move(data));
   }
 
   /**
@@ -301,11 +935,7 @@ public:
    * @param[in] data data to push
    */
   void PushFront(T const &data) {
-    start = allocator.alloc(data, nullptr, start);
-    if (tail == nullptr)
-      tail = start;
-    else
-      start->next->prev = start;
+    EmplaceFront(data);
   }
 
   /**
@@ -313,11 +943,128 @@ public:
    * @param[in] data data to push
    */
   void PushFront(T &&data) {
-    start = allocator.alloc(std::move(data), nullptr, start);
-    if (tail == nullptr)
-      tail = start;
-    else
-      start->next->prev = start;
+    EmplaceFront(std::move(data));
+  }
+
+  /**
+   * Push range of elements back function.
+   * Nodes are allocated from strategy with batches.
+   * @tparam InputIt range iterator type
+   * @param[in] first range begin
+   * @param[in] last range end
+   */
+  template <typename InputIt>
+  void PushBack(InputIt first, InputIt last) {
+    node_t *begin, *end;
+    size_t count = BuildList(first, last, begin, end);
+    if (count != 0)
+      LinkBefore(nullptr, begin, end, count);
+  }
+
+  /**
+   * Push list of elements back function.
+   * @param[in] list elements to push
+   */
+  void PushBack(std::initializer_list<T> list) {
+    PushBack(list.begin(), list.end());
+  }
+
+  /**
+   * Push range of elements front function.
+   * Range order is kept, so range first element becomes deque first element.
+   * Nodes are allocated from strategy with batches.
+   * @tparam InputIt range iterator type
+   * @param[in] first range begin
+   * @param[in] last range end
+   */
+  template <typename InputIt>
+  void PushFront(InputIt first, InputIt last) {
+    node_t *begin, *end;
+    size_t count = BuildList(first, last, begin, end);
+    if (count != 0)
+      LinkBefore(start, begin, end, count);
+  }
+
+  /**
+   * Push list of elements front function.
+   * @param[in] list elements to push
+   */
+  void PushFront(std::initializer_list<T> list) {
+    PushFront(list.begin(), list.end());
+  }
+
+  /**
+   * Pop several elements back function.
+   * Elements are written in pop order, nodes are returned to strategy with batches.
+   * @tparam OutputIt output iterator type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @return number of poped elements
+   */
+  template <typename OutputIt>
+  size_t PopBack(size_t count, OutputIt out) {
+    node_t *nodes[bulkBatch];
+    size_t poped = 0;
+    while (poped < count && tail != nullptr) {
+      size_t batch = 0;
+      try {
+        for (; batch < bulkBatch && poped < count && tail != nullptr; batch++, poped++) {
+          *out = std::move(tail->data);
+          ++out;
+          nodes[batch] = tail;
+          tail = tail->prev;
+          if (tail == nullptr)
+            start = nullptr;
+          else
+            tail->next = nullptr;
+          nodes[batch]->~node_t();
+          size--;
+        }
+      }
+      catch (...) {
+        ReleaseNodes(nodes, batch);
+        throw;
+      }
+      ReleaseNodes(nodes, batch);
+    }
+    return poped;
+  }
+
+  /**
+   * Pop several elements front function.
+   * Elements are written in pop order, nodes are returned to strategy with batches.
+   * @tparam OutputIt output iterator type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @return number of poped elements
+   */
+  template <typename OutputIt>
+  size_t PopFront(size_t count, OutputIt out) {
+    node_t *nodes[bulkBatch];
+    size_t poped = 0;
+    while (poped < count && start != nullptr) {
+      size_t batch = 0;
+      try {
+        for (; batch < bulkBatch && poped < count && start != nullptr; batch++, poped++) {
+          *out = std::move(start->data);
+          ++out;
+          nodes[batch] = start;
+          start = start->next;
+          if (start == nullptr)
+            tail = nullptr;
+          else
+            start->prev = nullptr;
+          nodes[batch]->~node_t();
+          size--;
+        }
+      }
+      catch (...) {
+        ReleaseNodes(nodes, batch);
+        throw;
+      }
+      ReleaseNodes(nodes, batch);
+    }
+    return poped;
   }
 
   /**
@@ -328,13 +1075,7 @@ public:
     if (tail == nullptr)
       throw std::exception("Empty list");
     T data = std::move(tail->data);
-    node_t *tmp = tail->prev;
-    allocator.dealloc(tail);
-    tail = tmp;
-    if (tmp == nullptr)
-      start = nullptr;
-    else
-      tail->next = nullptr;
+    EraseBack();
     return data;
   }
 
@@ -346,13 +1087,57 @@ public:
     if (start == nullptr)
       throw std::exception("Empty list");
     T data = std::move(start->data);
-    node_t *tmp = start->next;
-    allocator.dealloc(start);
-    start = tmp;
-    if (tmp == nullptr)
-      tail = nullptr;
-    else
-      start->prev = nullptr;
+    EraseFront();
+    return data;
+  }
+
+  /**
+   * Try to pop element back function. Does not throw on empty deque.
+   * @param[out] data poped element, assigned with move
+   * @return true if element was poped, false if deque is empty
+   */
+  bool TryPopBack(T &data) {
+    if (tail == nullptr)
+      return false;
+    data = std::move(tail->data);
+    EraseBack();
+    return true;
+  }
+
+  /**
+   * Try to pop element front function. Does not throw on empty deque.
+   * @param[out] data poped element, assigned with move
+   * @return true if element was poped, false if deque is empty
+   */
+  bool TryPopFront(T &data) {
+    if (start == nullptr)
+      return false;
+    data = std::move(start->data);
+    EraseFront();
+    return true;
+  }
+
+  /**
+   * Try to pop element back function. Does not throw on empty deque.
+   * @return poped element, empty if deque is empty
+   */
+  std::optional<T> TryPopBack(void) {
+    if (tail == nullptr)
+      return std::nullopt;
+    std::optional<T> data(std::move(tail->data));
+    EraseBack();
+    return data;
+  }
+
+  /**
+   * Try to pop element front function. Does not throw on empty deque.
+   * @return poped element, empty if deque is empty
+   */
+  std::optional<T> TryPopFront(void) {
+    if (start == nullptr)
+      return std::nullopt;
+    std::optional<T> data(std::move(start->data));
+    EraseFront();
     return data;
   }
 
@@ -364,39 +1149,264 @@ public:
     return start == nullptr;
   }
 
+  /**
+   * Get number of elements function.
+   * @return number of elements
+   */
+  size_t Size(void) const {
+    return size;
+  }
+
+  /**
+   * Get number of elements deque can hold without strategy calls function.
+   * @return number of elements
+   */
+  size_t Capacity(void) const {
+    return size + spareCount;
+  }
+
+  /**
+   * Reserve storage for elements function.
+   * Missing nodes are allocated from strategy with batches and kept as spare,
+   * pops keep freed nodes as spare while capacity is below reserved.
+   * Reservation is dropped when deque strategy is replaced by assignment or by copying to new strategy.
+   * @param[in] count number of elements deque must hold without strategy calls
+   */
+  void Reserve(size_t count) {
+    reserved = std::max(reserved, count);
+    node_t *nodes[bulkBatch];
+    while (size + spareCount < count) {
+      size_t batch = std::min(count - size - spareCount, bulkBatch);
+      allocator.allocRaw(batch, nodes);
+      for (size_t i = 0; i < batch; i++)
+        PushSpare(nodes[i]);
+    }
+  }
+
+  /**
+   * Return spare nodes to strategy and drop reservation function.
+   */
+  void ShrinkToFit(void) {
+    reserved = 0;
+    FreeSpare();
+  }
+
+  /**
+   * Get node cache size function.
+   * @return maximal number of freed nodes kept as spare regardless of reservation
+   */
+  size_t NodeCache(void) const {
+    return cacheLimit;
+  }
+
+  /**
+   * Set node cache size function. Spare nodes above new size and reservation are returned to strategy.
+   * @param[in] count maximal number of freed nodes kept as spare regardless of reservation, 0 disables cache
+   */
+  void SetNodeCache(size_t count) {
+    cacheLimit = count;
+    if (spareCount > cacheLimit)
+      FreeSpare(std::max(reserved, size + cacheLimit));
+  }
+
+  /**
+   * Return cached spare nodes to strategy function. Spare nodes of reservation and inline nodes are kept.
+   */
+  void Trim(void) {
+    FreeSpare(reserved);
+  }
+
   /**
    * Clear deque function.
+   * If elements need no destruction and deque is the only user of strategy, strategy memory is released at once
+   * as on destruction and spare nodes of reservation and node cache are allocated again.
+   * Otherwise nodes are kept as spare while capacity is below reserved or node cache is not full,
+   * rest is returned to strategy with batches.
    */
   void Clear(void) {
-    FreeList(start, allocator);
-    start = nullptr;
+    if (std::is_trivially_destructible<T>::value && allocator.release()) {
+      ResetNodes();
+      RefillSpare();
+      return;
+    }
+    node_t *nodes[bulkBatch];
+    while (start != nullptr) {
+      size_t batch = 0;
+      for (; batch < bulkBatch && start != nullptr; batch++) {
+        nodes[batch] = start;
+        start = start->next;
+        nodes[batch]->~node_t();
+        size--;
+      }
+      ReleaseNodes(nodes, batch);
+    }
     tail = nullptr;
   }
 
   /**
    * Change allocator strategy function.
+   * If deque is the only owner of its strategy and new strategy absorbs its memory, nodes are kept without copying.
+   * Otherwise elements are moved to nodes allocated from new strategy with batches and old nodes are freed,
+   * reservation is dropped in this case.
    * @param[in] strategy allocation strategy for deque
    */
   void ChangeAllocator(std::shared_ptr<alloc_strategy_t> const &strategy) {
-    auto prevAllocator = allocator;
-    node_t
-      *prevBegin = start,
-      *prevEnd = tail;
-    allocator = single_allocator_t<node_t>(strategy);
-    if (start == nullptr) {
-      start = nullptr;
-      tail = nullptr;
+    if (allocator.migrate(strategy))
       return;
+    deque_t moved(strategy);
+    moved.cacheLimit = cacheLimit;
+    moved.Reserve(size);
+    moved.reserved = 0;
+    for (node_t *node = start; node != nullptr; node = node->next)
+      moved.EmplaceBack(std::move(node->data));
+    *this = std::move(moved);
+  }
+
+  /**
+   * Move all elements of another deque before position function.
+   * With equal allocators node list is linked without copying in O(1),
+   * only elements of inline nodes are moved to nodes allocated from strategy.
+   * Otherwise elements are moved to nodes allocated with batches.
+   * Moved deque becomes empty and keeps its spare nodes.
+   * @param[in] pos position to insert elements before
+   * @param[in] rhs deque to take elements from
+   */
+  void Splice(const_iterator_t pos, deque_t &&rhs) {
+    if (this == &rhs || rhs.size == 0)
+      return;
+    node_t *next = const_cast<node_t *>(pos.node);
+    if (!(allocator == rhs.allocator)) {
+      node_t *begin, *end;
+      size_t count = BuildList(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()), begin, end, rhs.size);
+      rhs.Clear();
+      LinkBefore(next, begin, end, count);
+      return;
+    }
+    node_t *begin = rhs.DetachInline(rhs.start);
+    LinkBefore(next, begin, rhs.tail, rhs.size);
+    rhs.start = nullptr;
+    rhs.tail = nullptr;
+    rhs.size = 0;
+  }
+
+  /**
+   * Move all elements of another deque to back function. See 'Splice'.
+   * @param[in] rhs deque to take elements from
+   */
+  void Append(deque_t &&rhs) {
+    Splice(end(), std::move(rhs));
+  }
+
+  /**
+   * Detach elements from position to end into new deque function.
+   * Node list is cut without copying, only elements of inline nodes are moved to nodes allocated from strategy.
+   * Number of detached elements is counted from position in both directions, so cost is the smallest of parts sizes.
+   * Iterators to detached elements stay valid for element access.
+   * @param[in] pos first detached element position
+   * @return deque with detached elements and the same allocator
+   */
+  deque_t SplitAt(const_iterator_t pos) {
+    deque_t suffix(allocator);
+    suffix.cacheLimit = cacheLimit;
+    node_t *begin = const_cast<node_t *>(pos.node);
+    if (begin == nullptr)
+      return suffix;
+    begin = DetachInline(begin);
+    size_t count = CountToEnd(begin);
+    suffix.start = begin;
+    suffix.tail = tail;
+    suffix.size = count;
+    tail = begin->prev;
+    (tail == nullptr ? start : tail->next) = nullptr;
+    begin->prev = nullptr;
+    size -= count;
+    return suffix;
+  }
+
+  /**
+   * Split deque into ranges of neighbouring elements function.
+   * List is walked once to find ranges bounds, ranges have equal number of elements up to one.
+   * @param[in] numOfParts maximal number of ranges
+   * @return ranges in deque order, no empty ranges
+   */
+  std::vector<std::pair<iterator_t, iterator_t>> Partition(size_t numOfParts) {
+    std::vector<std::pair<iterator_t, iterator_t>> parts;
+    numOfParts = std::min(std::max<size_t>(numOfParts, 1), size);
+    node_t *node = start;
+    for (size_t part = 0; part < numOfParts; part++) {
+      iterator_t begin(node, this);
+      for (size_t i = size * part / numOfParts; i < size * (part + 1) / numOfParts; i++)
+        node = node->next;
+      parts.emplace_back(begin, iterator_t(node, this));
     }
-    start = allocator.alloc(std::move(*start));
-    node_t *prev = start;
-    for (node_t const *node = start->next; node != nullptr; node = node->next, prev = prev->next) {
-      node_t *tmp = allocator.alloc(std::move(node->data), prev, nullptr);
-      prev->next = tmp;
+    return parts;
+  }
+
+  /**
+   * Split constant deque into ranges of neighbouring elements function.
+   * List is walked once to find ranges bounds, ranges have equal number of elements up to one.
+   * @param[in] numOfParts maximal number of ranges
+   * @return ranges in deque order, no empty ranges
+   */
+  std::vector<std::pair<const_iterator_t, const_iterator_t>> Partition(size_t numOfParts) const {
+    std::vector<std::pair<const_iterator_t, const_iterator_t>> parts;
+    numOfParts = std::min(std::max<size_t>(numOfParts, 1), size);
+    node_t const *node = start;
+    for (size_t part = 0; part < numOfParts; part++) {
+      const_iterator_t begin(node, this);
+      for (size_t i = size * part / numOfParts; i < size * (part + 1) / numOfParts; i++)
+        node = node->next;
+      parts.emplace_back(begin, const_iterator_t(node, this));
     }
-    tail = prev;
-    prev->next = nullptr;
-    FreeList(start, prevAllocator);
+    return parts;
+  }
+
+  /**
+   * Call function for every element function.
+   * Elements are visited in order by plain loop over nodes without iterator checks.
+   * @tparam Fn function type, called with element reference
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEach(Fn fn) {
+    for (node_t *node = start; node != nullptr; node = node->next)
+      fn(node->data);
+  }
+
+  /**
+   * Call function for every constant element function.
+   * Elements are visited in order by plain loop over nodes without iterator checks.
+   * @tparam Fn function type, called with constant element reference
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEach(Fn fn) const {
+    for (node_t const *node = start; node != nullptr; node = node->next)
+      fn(node->data);
+  }
+
+  /**
+   * Call function for every contiguous span of elements function.
+   * Every node is a separate span of one element, so callers use the same code for list and block deques.
+   * @tparam Fn function type, called with pointer to first span element and number of span elements
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEachBlock(Fn fn) {
+    for (node_t *node = start; node != nullptr; node = node->next)
+      fn(&node->data, size_t(1));
+  }
+
+  /**
+   * Call function for every contiguous span of constant elements function.
+   * Every node is a separate span of one element, so callers use the same code for list and block deques.
+   * @tparam Fn function type, called with pointer to first constant span element and number of span elements
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEachBlock(Fn fn) const {
+    for (node_t const *node = start; node != nullptr; node = node->next)
+      fn(&node->data, size_t(1));
   }
 
   /**
@@ -404,7 +1414,7 @@ public:
    * @return begin iterator
    */
   iterator_t begin(void) {
-    return iterator_t(start);
+    return iterator_t(start, this);
   }
 
   /**
@@ -412,21 +1422,64 @@ public:
    * @return end iterator
    */
   iterator_t end(void) {
-    return iterator_t(nullptr);
+    return iterator_t(nullptr, this);
+  }
+
+  /**
+   * Get constant begin iterator function.
+   * @return constant begin iterator
+   */
+  const_iterator_t begin(void) const {
+    return const_iterator_t(start, this);
+  }
+
+  /**
+   * Get constant end iterator function.
+   * @return constant end iterator
+   */
+  const_iterator_t end(void) const {
+    return const_iterator_t(nullptr, this);
+  }
+
+  /**
+   * Get constant begin iterator function.
+   * @return constant begin iterator
+   */
+  const_iterator_t cbegin(void) const {
+    return begin();
+  }
+
+  /**
+   * Get constant end iterator function.
+   * @return constant end iterator
+   */
+  const_iterator_t cend(void) const {
+    return end();
   }
 };
 
+/**
+ * @brief Deque with inline storage type.
+ * @tparam T deque elements type
+ * @tparam InlineCapacity number of nodes stored inside deque object
+ * @tparam Strategy allocation strategy type, 'alloc_strategy_t' means runtime strategy
+ */
+template <typename T, size_t InlineCapacity, typename Strategy = alloc_strategy_t>
+using small_deque_t = deque_t<T, Strategy, InlineCapacity>;
+
 /**
  * Operator<< for deque and output stream.
  * @tparam T deque elements type
+ * @tparam Strategy allocation strategy type
+ * @tparam InlineCapacity number of nodes stored inside deque
  * @param[in] stream output stream
  * @param[in] deq deque to output
  * @return reference to stream
  */
-template <typename T>
-std::ostream &operator<<(std::ostream &stream, deque_t<T> const &deq) {
-  for (deque_t<T>::node_t *node = deq.start; node != nullptr; node = node->next)
-    std::cout << node->data << ", ";
+template <typename T, typename Strategy, size_t InlineCapacity>
+std::ostream &operator<<(std::ostream &stream, deque_t<T, Strategy, InlineCapacity> const &deq) {
+  for (T const &data : deq)
+    stream << data << ", ";
   return stream;
 }
 
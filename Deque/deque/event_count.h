@@ -0,0 +1,164 @@
+/**
+ * @file
+ * @brief Event count header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains notification primitive which lets consumers sleep until producers publish data
+ */
+
+#pragma once
+
+#ifndef __EVENT_COUNT_H_INCLUDED
+#define __EVENT_COUNT_H_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "Synchronization.lib")
+#endif
+#else
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Event count class.
+ *
+ * Waiters register themselves, check condition and sleep on epoch word while it is unchanged;
+ * notification changes epoch and wakes waiters only if someone is registered.
+ * Sleeping uses futex on Linux and WaitOnAddress on Windows, so notification without waiters
+ * costs one fence and one load, and syscalls are made only when consumer really sleeps.
+ */
+class event_count_t {
+public:
+  using clock_t = std::chrono::steady_clock;  ///< deadlines clock type
+
+private:
+  std::atomic<std::uint32_t> epoch;    ///< notifications counter, waiters sleep on it
+  std::atomic<std::uint32_t> waiters;  ///< number of registered waiters
+
+  /**
+   * Sleep while epoch equals value function. May return earlier.
+   * @param[in] key epoch value read on registration
+   * @param[in] deadline wake up time, nullptr to sleep without timeout
+   */
+  void Sleep(std::uint32_t key, clock_t::time_point const *deadline) {
+#ifdef _WIN32
+    DWORD ms = INFINITE;
+    if (deadline != nullptr) {
+      auto left = std::chrono::ceil<std::chrono::milliseconds>(*deadline - clock_t::now()).count();
+      ms = left <= 0 ? 0 : left >= INFINITE ? INFINITE - 1 : static_cast<DWORD>(left);
+    }
+    WaitOnAddress(&epoch, &key, sizeof(key), ms);
+#else
+    timespec timeout, *timeoutPtr = nullptr;
+    if (deadline != nullptr) {
+      auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(*deadline - clock_t::now()).count();
+      if (left <= 0)
+        return;
+      timeout.tv_sec = static_cast<time_t>(left / 1000000000);
+      timeout.tv_nsec = static_cast<long>(left % 1000000000);
+      timeoutPtr = &timeout;
+    }
+    syscall(SYS_futex, &epoch, FUTEX_WAIT_PRIVATE, key, timeoutPtr, nullptr, 0);
+#endif
+  }
+
+  /**
+   * Wake sleeping waiters function.
+   * @param[in] all wake all waiters flag, otherwise one waiter is woken
+   */
+  void Wake(bool all) {
+#ifdef _WIN32
+    if (all)
+      WakeByAddressAll(&epoch);
+    else
+      WakeByAddressSingle(&epoch);
+#else
+    syscall(SYS_futex, &epoch, FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, nullptr, nullptr, 0);
+#endif
+  }
+
+public:
+  /**
+   * Default constructor.
+   */
+  event_count_t(void) : epoch(0), waiters(0) {
+  }
+
+  /**
+   * Deleted copy constructor.
+   */
+  event_count_t(event_count_t const &) = delete;
+
+  /**
+   * Deleted copy operator =.
+   */
+  event_count_t &operator=(event_count_t const &) = delete;
+
+  /**
+   * Get deadline after timeout function.
+   * @tparam Rep timeout representation type
+   * @tparam Period timeout period type
+   * @param[in] timeout time to wait from now
+   * @return deadline time point
+   */
+  template <typename Rep, typename Period>
+  static clock_t::time_point Deadline(std::chrono::duration<Rep, Period> const &timeout) {
+    return clock_t::now() + std::chrono::duration_cast<clock_t::duration>(timeout);
+  }
+
+  /**
+   * Notify waiters after data publication function.
+   * @param[in] all wake all waiters flag, otherwise one waiter is woken
+   */
+  void Notify(bool all = false) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) == 0)
+      return;
+    epoch.fetch_add(1, std::memory_order_seq_cst);
+    Wake(all);
+  }
+
+  /**
+   * Wait until condition is satisfied function.
+   * Condition is checked first without registration, then after every registration and wake up.
+   * @tparam TryFn condition type, called without arguments, returns true on success
+   * @param[in] tryFn condition, usually try to pop
+   * @param[in] deadline time to give up, nullptr to wait without timeout
+   * @return true if condition was satisfied, false on timeout
+   */
+  template <typename TryFn>
+  bool Wait(TryFn tryFn, clock_t::time_point const *deadline = nullptr) {
+    if (tryFn())
+      return true;
+    for (;;) {
+      waiters.fetch_add(1, std::memory_order_seq_cst);
+      // pairs with fence in 'Notify': either condition check sees published data or notifier sees waiter
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      std::uint32_t key = epoch.load(std::memory_order_seq_cst);
+      if (tryFn()) {
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+      if (deadline != nullptr && clock_t::now() >= *deadline) {
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+      }
+      Sleep(key, deadline);
+      waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+};
+
+#endif /* __EVENT_COUNT_H_INCLUDED */
@@ -0,0 +1,29 @@
+/**
+ * @file
+ * @brief Deque iterator checks header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains macro which selects checked or unchecked deque iterators
+ */
+
+#pragma once
+
+#ifndef __ITERATOR_CHECKS_H_INCLUDED
+#define __ITERATOR_CHECKS_H_INCLUDED
+
+/**
+ * Checked iterators flag macro.
+ * Checked iterators throw on end iterator dereference and on moving over deque bounds,
+ * unchecked iterators have no such tests in iteration loops.
+ * By default iterators are checked in debug builds and unchecked if NDEBUG is defined,
+ * define macro as 0 or 1 before including deques to select mode explicitly.
+ */
+#ifndef DEQUE_CHECKED_ITERATORS
+#ifdef NDEBUG
+#define DEQUE_CHECKED_ITERATORS 0
+#else
+#define DEQUE_CHECKED_ITERATORS 1
+#endif /* NDEBUG */
+#endif /* DEQUE_CHECKED_ITERATORS */
+
+#endif /* __ITERATOR_CHECKS_H_INCLUDED */
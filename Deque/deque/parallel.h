@@ -0,0 +1,171 @@
+/**
+ * @file
+ * @brief Parallel deque algorithms header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains transform, reduce and find algorithms which process deque ranges on several threads
+ */
+
+#pragma once
+
+#ifndef __PARALLEL_H_INCLUDED
+#define __PARALLEL_H_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Parallel algorithms options struct.
+ */
+struct parallel_options_t {
+  size_t
+    numOfThreads = 0,        ///< number of threads, 0 means hardware concurrency
+    minPartSize = 16 * 1024; ///< minimal number of elements processed by one thread
+};
+
+/**
+ * @brief Parallel algorithms implementation namespace.
+ */
+namespace parallel_detail {
+  /**
+   * Get number of deque parts for parallel processing function.
+   * @param[in] size number of deque elements
+   * @param[in] options parallel options
+   * @return number of parts, at least 1
+   */
+  inline size_t NumOfParts(size_t size, parallel_options_t const &options) {
+    size_t numOfThreads = options.numOfThreads != 0 ? options.numOfThreads : std::thread::hardware_concurrency();
+    return std::max<size_t>(1, std::min(std::max<size_t>(numOfThreads, 1), size / std::max<size_t>(options.minPartSize, 1)));
+  }
+
+  /**
+   * Run function for every deque range on separate thread function.
+   * Last range is processed by calling thread, first exception thrown by range function is rethrown after all threads end.
+   * @tparam Parts ranges container type
+   * @tparam Fn range function type, called with range index, range begin and range end
+   * @param[in] parts deque ranges
+   * @param[in] fn range function
+   */
+  template <typename Parts, typename Fn>
+  void RunParts(Parts const &parts, Fn fn) {
+    std::vector<std::exception_ptr> errors(parts.size());
+    std::vector<std::thread> threads;
+    threads.reserve(parts.size());
+    auto run = [&parts, &fn, &errors](size_t part) {
+      try {
+        fn(part, parts[part].first, parts[part].second);
+      }
+      catch (...) {
+        errors[part] = std::current_exception();
+      }
+    };
+    try {
+      for (size_t part = 0; part + 1 < parts.size(); part++)
+        threads.emplace_back(run, part);
+    }
+    catch (...) {
+      for (auto &thread : threads)
+        thread.join();
+      throw;
+    }
+    if (!parts.empty())
+      run(parts.size() - 1);
+    for (auto &thread : threads)
+      thread.join();
+    for (auto &error : errors)
+      if (error != nullptr)
+        std::rethrow_exception(error);
+  }
+}
+
+/**
+ * Transform every deque element in place on several threads function.
+ * Deque is split into ranges of neighbouring elements (storage blocks or list nodes),
+ * every range is processed by one thread. Deque must not be changed during call.
+ * @tparam Deque deque type
+ * @tparam UnaryOp transformation type
+ * @param[in, out] deq deque to transform
+ * @param[in] op transformation, every element is assigned with op(element)
+ * @param[in] options parallel options
+ */
+template <typename Deque, typename UnaryOp>
+void ParallelTransform(Deque &deq, UnaryOp op, parallel_options_t const &options = parallel_options_t()) {
+  auto parts = deq.Partition(parallel_detail::NumOfParts(deq.Size(), options));
+  parallel_detail::RunParts(parts, [&op](size_t, auto begin, auto end) {
+    for (; begin != end; ++begin)
+      *begin = op(*begin);
+  });
+}
+
+/**
+ * Reduce deque elements on several threads function.
+ * Every range of neighbouring elements is reduced by one thread starting with its first element,
+ * ranges results are combined in deque order, so operation must be associative but may be not commutative.
+ * Elements must be convertible to result type.
+ * @tparam Deque deque type
+ * @tparam R result type
+ * @tparam BinaryOp reduction type
+ * @param[in] deq deque to reduce
+ * @param[in] init initial value, combined with first element
+ * @param[in] op reduction
+ * @param[in] options parallel options
+ * @return reduction result, init for empty deque
+ */
+template <typename Deque, typename R, typename BinaryOp>
+R ParallelReduce(Deque const &deq, R init, BinaryOp op, parallel_options_t const &options = parallel_options_t()) {
+  auto parts = deq.Partition(parallel_detail::NumOfParts(deq.Size(), options));
+  std::vector<std::optional<R>> results(parts.size());
+  parallel_detail::RunParts(parts, [&op, &results](size_t part, auto begin, auto end) {
+    R result = *begin;
+    for (++begin; begin != end; ++begin)
+      result = op(std::move(result), *begin);
+    results[part].emplace(std::move(result));
+  });
+  for (auto &result : results)
+    init = op(std::move(init), std::move(*result));
+  return init;
+}
+
+/**
+ * Find first deque element satisfying predicate on several threads function.
+ * Threads stop when element is found in one of previous ranges, predicate may be called for elements after result.
+ * @tparam Deque deque type
+ * @tparam Pred predicate type
+ * @param[in] deq deque to search
+ * @param[in] pred predicate
+ * @param[in] options parallel options
+ * @return iterator to first found element, end iterator if there is no such element
+ */
+template <typename Deque, typename Pred>
+auto ParallelFindIf(Deque &deq, Pred pred, parallel_options_t const &options = parallel_options_t()) -> decltype(deq.end()) {
+  using iterator_t = decltype(deq.end());
+  static constexpr size_t checkPeriod = 1024;  // number of elements between checks of found position
+
+  auto parts = deq.Partition(parallel_detail::NumOfParts(deq.Size(), options));
+  std::vector<std::optional<iterator_t>> results(parts.size());
+  std::atomic<size_t> foundPart(parts.size());
+  parallel_detail::RunParts(parts, [&pred, &results, &foundPart](size_t part, iterator_t begin, iterator_t end) {
+    for (size_t i = 0; begin != end; ++begin, i++) {
+      if (i % checkPeriod == 0 && foundPart.load(std::memory_order_relaxed) < part)
+        return;
+      if (pred(*begin)) {
+        results[part].emplace(begin);
+        size_t found = foundPart.load(std::memory_order_relaxed);
+        while (part < found && !foundPart.compare_exchange_weak(found, part, std::memory_order_relaxed))
+          ;
+        return;
+      }
+    }
+  });
+  for (auto &result : results)
+    if (result)
+      return *result;
+  return deq.end();
+}
+
+#endif /* __PARALLEL_H_INCLUDED */
@@ -0,0 +1,679 @@
+/**
+ * @file
+ * @brief Persistent deque header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains deque class which lives in memory mapped file and is reopened after restart
+ */
+
+#pragma once
+
+#ifndef __PERSISTENT_DEQUE_H_INCLUDED
+#define __PERSISTENT_DEQUE_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "../allocator/allocator.h"
+#include "../allocator/mapped_file_strategy.h"
+#include "iterator_checks.h"
+
+/**
+ * @brief Template persistent deque class.
+ * @tparam T deque elements type, trivially copyable
+ *
+ * Doubly linked list of nodes allocated from mapped file strategy, nodes are linked by file offsets,
+ * so deque is found in reopened file through strategy root slot without deserialization.
+ * Links are changed in order which keeps list from first node by next links valid at any moment:
+ * first node and next links are published with release stores which compiler does not reorder with other stores,
+ * so deque of process killed at any point (process crash, not system crash) is recovered on opening by one walk over list,
+ * nodes which were being pushed or poped on crash may stay allocated.
+ * Changes reach file with dirty pages written by system, 'Flush' waits for them.
+ * Deque is not copyable, every instance owns its root slot.
+ */
+template <typename T>
+class persistent_deque_t {
+  static_assert(std::is_trivially_copyable<T>::value, "Persistent deque elements must be trivially copyable");
+  static_assert(alignof(T) <= mapped_file_strategy_t::blockAlignment, "Persistent deque elements alignment is too big");
+
+private:
+  /**
+   * @brief List node struct.
+   */
+  struct node_t {
+    std::atomic<std::uint64_t> next;  ///< offset of next node, 0 for last node
+    std::uint64_t prev;               ///< offset of previous node, 0 for first node
+    T data;                ///< element
+
+    /**
+     * Constructor with data constructor arguments.
+     * @tparam Args data constructor argument types
+     * @param[in] newPrev offset of previous node
+     * @param[in] newNext offset of next node
+     * @param[in] dataArgs data constructor arguments
+     */
+    template <typename... Args>
+    node_t(std::uint64_t newPrev, std::uint64_t newNext, Args&&... dataArgs) :
+      next(newNext), prev(newPrev), data(std::forward<Args>(dataArgs)...) {
+    }
+  };
+
+  /**
+   * @brief Deque state struct.
+   *
+   * Lies in mapped file at offset from strategy root slot.
+   */
+  struct state_t {
+    std::uint64_t
+      stateMark,                      ///< deque state mark
+      format;                         ///< element size
+    std::atomic<std::uint64_t> head;  ///< offset of first node
+    std::uint64_t
+      tail,                           ///< offset of last node
+      size,                           ///< number of elements
+      clean;                          ///< deque was destroyed properly flag
+  };
+
+  static constexpr std::uint64_t mark = 0x3145555145445350;  ///< deque state mark, "PSDEQUE1" in little endian
+
+  std::shared_ptr<mapped_file_strategy_t> file;  ///< mapped file strategy
+  single_allocator_t<node_t> allocator;          ///< allocator for nodes
+  state_t *state;                                ///< deque state in mapped file
+
+  /**
+   * Get node by offset function.
+   * @param[in] nodeOffset node offset, may be 0
+   * @return pointer to node, nullptr for offset 0
+   */
+  node_t *Node(std::uint64_t nodeOffset) const {
+    return static_cast<node_t *>(file->address(nodeOffset));
+  }
+
+  /**
+   * Publish link to node function.
+   * Stores before and after link are not moved over it, so list walked from first node after process crash
+   * never reaches node which is not constructed yet or is already freed.
+   * @param[in] link first node or next link to change
+   * @param[in] nodeOffset offset of linked node, 0 for no node
+   */
+  static void Publish(std::atomic<std::uint64_t> &link, std::uint64_t nodeOffset) {
+    link.store(nodeOffset, std::memory_order_release);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  }
+
+  /**
+   * Rebuild previous links, last node and size by next links function.
+   */
+  void Recover(void) {
+    std::uint64_t prev = 0, size = 0;
+    for (std::uint64_t node = state->head; node != 0; node = Node(node)->next, size++) {
+      Node(node)->prev = prev;
+      prev = node;
+    }
+    state->tail = prev;
+    state->size = size;
+  }
+
+  /**
+   * Remove last node function. Deque must be not empty.
+   */
+  void EraseBack(void) {
+    node_t *node = Node(state->tail);
+    std::uint64_t prev = node->prev;
+    Publish(prev == 0 ? state->head : Node(prev)->next, 0);
+    state->tail = prev;
+    state->size--;
+    allocator.dealloc(node);
+  }
+
+  /**
+   * Remove first node function. Deque must be not empty.
+   */
+  void EraseFront(void) {
+    node_t *node = Node(state->head);
+    std::uint64_t next = node->next;
+    Publish(state->head, next);
+    if (next == 0)
+      state->tail = 0;
+    else
+      Node(next)->prev = 0;
+    state->size--;
+    allocator.dealloc(node);
+  }
+
+  /**
+   * @brief Deque iterator class.
+   * @tparam IsConst constant iterator flag
+   *
+   * Bidirectional iterator over list nodes, end iterator is decremented to last element.
+   * Iterators are invalidated only by removal of iterated element and by deque destruction.
+   * Dereference of end iterator and moving over deque bounds throw only with checked iterators (see DEQUE_CHECKED_ITERATORS).
+   */
+  template <bool IsConst>
+  class basic_iterator_t {
+    template <bool> friend class basic_iterator_t;
+
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;                   ///< iterator category
+    using value_type = T;                                                        ///< element type
+    using difference_type = std::ptrdiff_t;                                      ///< iterators distance type
+    using pointer = typename std::conditional<IsConst, T const *, T *>::type;    ///< element pointer type
+    using reference = typename std::conditional<IsConst, T const &, T &>::type;  ///< element reference type
+
+  private:
+    using deque_ptr_t = typename std::conditional<IsConst, persistent_deque_t const *, persistent_deque_t *>::type;  ///< iterated deque pointer type
+
+    node_t *node;      ///< current node, nullptr for end iterator
+    deque_ptr_t deq;   ///< iterated deque
+
+  public:
+    /**
+     * Default constructor. Iterator is singular.
+     */
+    basic_iterator_t(void) : node(nullptr), deq(nullptr) {
+    }
+
+    /**
+     * Constructor by node and deque.
+     * @param[in] n node for iterator
+     * @param[in] d deque for iterator
+     */
+    basic_iterator_t(node_t *n, deque_ptr_t d) : node(n), deq(d) {
+    }
+
+    /**
+     * Conversion constructor from modifying iterator to constant iterator.
+     * @tparam WasConst converted iterator constant flag
+     * @param[in] lhs iterator to convert
+     */
+    template <bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+    basic_iterator_t(basic_iterator_t<WasConst> const &lhs) : node(lhs.node), deq(lhs.deq) {
+    }
+
+    /**
+     * Equality operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator==(basic_iterator_t<IsConst1> const &lhs) const {
+      return node == lhs.node;
+    }
+
+    /**
+     * Inequality operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator!=(basic_iterator_t<IsConst1> const &lhs) const {
+      return node != lhs.node;
+    }
+
+    /**
+     * Operator * to provide pointer semantics.
+     * @return data reference
+     */
+    reference operator*(void) const {
+#if DEQUE_CHECKED_ITERATORS
+      if (node == nullptr)
+        throw std::exception("Try to use end iterator");
+#endif /* DEQUE_CHECKED_ITERATORS */
+      return node->data;
+    }
+
+    /**
+     * Operator -> to provide pointer semantics.
+     * @return data pointer
+     */
+    pointer operator->(void) const {
+      return &**this;
+    }
+
+    /**
+     * Prefix increment.
+     * @return current iterator value
+     */
+    basic_iterator_t &operator++(void) {
+#if DEQUE_CHECKED_ITERATORS
+      if (node == nullptr)
+        throw std::exception("Try to use end iterator");
+#endif /* DEQUE_CHECKED_ITERATORS */
+      node = deq->Node(node->next);
+      return *this;
+    }
+
+    /**
+     * Postfix increment.
+     * @param[in] unusedInteger unused argument
+     * @return previous iterator value
+     */
+    basic_iterator_t operator++(int unusedInteger) {
+      basic_iterator_t tmp{*this};
+      ++*this;
+      return tmp;
+    }
+
+    /**
+     * Prefix decrement.
+     * @return current iterator value
+     */
+    basic_iterator_t &operator--(void) {
+      node_t *prev = deq->Node(node == nullptr ? deq->state->tail : node->prev);
+#if DEQUE_CHECKED_ITERATORS
+      if (prev == nullptr)
+        throw std::exception("Try to move before begin iterator");
+#endif /* DEQUE_CHECKED_ITERATORS */
+      node = prev;
+      return *this;
+    }
+
+    /**
+     * Postfix decrement.
+     * @param[in] unusedInteger unused argument
+     * @return previous iterator value
+     */
+    basic_iterator_t operator--(int unusedInteger) {
+      basic_iterator_t tmp{*this};
+      --*this;
+      return tmp;
+    }
+  };
+
+public:
+  using iterator_t = basic_iterator_t<false>;       ///< modifying iterator type
+  using const_iterator_t = basic_iterator_t<true>;  ///< constant iterator type
+
+  /**
+   * Constructor. Opens deque of root slot or creates empty one.
+   * Deque which was not destroyed properly is recovered.
+   * @param[in] mappedFile mapped file strategy
+   * @param[in] rootIndex strategy root slot index
+   */
+  explicit persistent_deque_t(std::shared_ptr<mapped_file_strategy_t> const &mappedFile, size_t rootIndex = 0) :
+    file(mappedFile), allocator(mappedFile), state(nullptr) {
+    std::uint64_t &root = file->root(rootIndex);
+    if (root == 0) {
+      state = new (file->alloc(sizeof(state_t))) state_t{mark, sizeof(T), 0, 0, 0, 0};
+      root = file->offset(state);
+      return;
+    }
+    state = static_cast<state_t *>(file->address(root));
+    if (state->stateMark != mark || state->format != sizeof(T))
+      throw std::exception("Persistent deque element type mismatch");
+    if (state->clean == 0)
+      Recover();
+    state->clean = 0;
+  }
+
+  /**
+   * Deleted copy constructor.
+   */
+  persistent_deque_t(persistent_deque_t const &) = delete;
+
+  /**
+   * Deleted copy operator =.
+   */
+  persistent_deque_t &operator=(persistent_deque_t const &) = delete;
+
+  /**
+   * Destructor. Marks deque as destroyed properly, elements stay in file.
+   */
+  ~persistent_deque_t(void) {
+    state->clean = 1;
+  }
+
+  /**
+   * Construct element back in place function.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   * @return reference to constructed element
+   */
+  template <typename... Args>
+  T &EmplaceBack(Args&&... constructorArgs) {
+    node_t *node = allocator.alloc(state->tail, std::uint64_t(0), std::forward<Args>(constructorArgs)...);
+    std::uint64_t nodeOffset = file->offset(node);
+    Publish(state->tail == 0 ? state->head : Node(state->tail)->next, nodeOffset);
+    state->tail = nodeOffset;
+    state->size++;
+    return node->data;
+  }
+
+  /**
+   * Construct element front in place function.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   * @return reference to constructed element
+   */
+  template <typename... Args>
+  T &EmplaceFront(Args&&... constructorArgs) {
+    std::uint64_t next = state->head;
+    node_t *node = allocator.alloc(std::uint64_t(0), next, std::forward<Args>(constructorArgs)...);
+    std::uint64_t nodeOffset = file->offset(node);
+    Publish(state->head, nodeOffset);
+    if (next == 0)
+      state->tail = nodeOffset;
+    else
+      Node(next)->prev = nodeOffset;
+    state->size++;
+    return node->data;
+  }
+
+  /**
+   * Push element back function.
+   * @param[in] data data to push
+   */
+  void PushBack(T const &data) {
+    EmplaceBack(data);
+  }
+
+  /**
+   * Push element front function.
+   * @param[in] data data to push
+   */
+  void PushFront(T const &data) {
+    EmplaceFront(data);
+  }
+
+  /**
+   * Push range of elements back function.
+   * @tparam InputIt range iterator type
+   * @param[in] first range begin
+   * @param[in] last range end
+   */
+  template <typename InputIt>
+  void PushBack(InputIt first, InputIt last) {
+    for (; first != last; ++first)
+      EmplaceBack(*first);
+  }
+
+  /**
+   * Push list of elements back function.
+   * @param[in] list elements to push
+   */
+  void PushBack(std::initializer_list<T> list) {
+    PushBack(list.begin(), list.end());
+  }
+
+  /**
+   * Push range of elements front function.
+   * Range order is kept, so range first element becomes deque first element.
+   * @tparam BidirIt range iterator type
+   * @param[in] first range begin
+   * @param[in] last range end
+   */
+  template <typename BidirIt>
+  void PushFront(BidirIt first, BidirIt last) {
+    while (last != first)
+      EmplaceFront(*--last);
+  }
+
+  /**
+   * Push list of elements front function.
+   * @param[in] list elements to push
+   */
+  void PushFront(std::initializer_list<T> list) {
+    PushFront(list.begin(), list.end());
+  }
+
+  /**
+   * Pop several elements back function.
+   * Elements are written in pop order.
+   * @tparam OutputIt output iterator type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @return number of poped elements
+   */
+  template <typename OutputIt>
+  size_t PopBack(size_t count, OutputIt out) {
+    size_t poped = 0;
+    for (; poped < count && state->size != 0; poped++) {
+      *out = Node(state->tail)->data;
+      ++out;
+      EraseBack();
+    }
+    return poped;
+  }
+
+  /**
+   * Pop several elements front function.
+   * Elements are written in pop order.
+   * @tparam OutputIt output iterator type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @return number of poped elements
+   */
+  template <typename OutputIt>
+  size_t PopFront(size_t count, OutputIt out) {
+    size_t poped = 0;
+    for (; poped < count && state->size != 0; poped++) {
+      *out = Node(state->head)->data;
+      ++out;
+      EraseFront();
+    }
+    return poped;
+  }
+
+  /**
+   * Pop element back function.
+   * @return poped element
+   */
+  T PopBack(void) {
+    if (state->size == 0)
+      throw std::exception("Empty list");
+    T data = Node(state->tail)->data;
+    EraseBack();
+    return data;
+  }
+
+  /**
+   * Pop element front function.
+   * @return poped element
+   */
+  T PopFront(void) {
+    if (state->size == 0)
+      throw std::exception("Empty list");
+    T data = Node(state->head)->data;
+    EraseFront();
+    return data;
+  }
+
+  /**
+   * Try to pop element back function. Does not throw on empty deque.
+   * @param[out] data poped element
+   * @return true if element was poped, false if deque is empty
+   */
+  bool TryPopBack(T &data) {
+    if (state->size == 0)
+      return false;
+    data = Node(state->tail)->data;
+    EraseBack();
+    return true;
+  }
+
+  /**
+   * Try to pop element front function. Does not throw on empty deque.
+   * @param[out] data poped element
+   * @return true if element was poped, false if deque is empty
+   */
+  bool TryPopFront(T &data) {
+    if (state->size == 0)
+      return false;
+    data = Node(state->head)->data;
+    EraseFront();
+    return true;
+  }
+
+  /**
+   * Try to pop element back function. Does not throw on empty deque.
+   * @return poped element, empty if deque is empty
+   */
+  std::optional<T> TryPopBack(void) {
+    if (state->size == 0)
+      return std::nullopt;
+    std::optional<T> data(Node(state->tail)->data);
+    EraseBack();
+    return data;
+  }
+
+  /**
+   * Try to pop element front function. Does not throw on empty deque.
+   * @return poped element, empty if deque is empty
+   */
+  std::optional<T> TryPopFront(void) {
+    if (state->size == 0)
+      return std::nullopt;
+    std::optional<T> data(Node(state->head)->data);
+    EraseFront();
+    return data;
+  }
+
+  /**
+   * Is empty check function.
+   * @return true if deque is empty, false - otherwise
+   */
+  bool IsEmpty(void) const {
+    return state->size == 0;
+  }
+
+  /**
+   * Get number of elements function.
+   * @return number of elements
+   */
+  size_t Size(void) const {
+    return static_cast<size_t>(state->size);
+  }
+
+  /**
+   * Clear deque function. Nodes are returned to strategy.
+   */
+  void Clear(void) {
+    while (state->size != 0)
+      EraseFront();
+  }
+
+  /**
+   * Write changed pages of mapped file to disk and wait for it function.
+   */
+  void Flush(void) {
+    file->flush();
+  }
+
+  /**
+   * Call function for every element function.
+   * @tparam Fn function type, called with element reference
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEach(Fn fn) {
+    for (node_t *node = Node(state->head); node != nullptr; node = Node(node->next))
+      fn(node->data);
+  }
+
+  /**
+   * Call function for every constant element function.
+   * @tparam Fn function type, called with constant element reference
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEach(Fn fn) const {
+    for (node_t const *node = Node(state->head); node != nullptr; node = Node(node->next))
+      fn(node->data);
+  }
+
+  /**
+   * Call function for every contiguous block of elements function.
+   * Every list node is a block of one element.
+   * @tparam Fn function type, called with pointer to first block element and number of block elements
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEachBlock(Fn fn) {
+    for (node_t *node = Node(state->head); node != nullptr; node = Node(node->next))
+      fn(&node->data, size_t(1));
+  }
+
+  /**
+   * Call function for every contiguous block of constant elements function.
+   * Every list node is a block of one element.
+   * @tparam Fn function type, called with pointer to first constant block element and number of block elements
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEachBlock(Fn fn) const {
+    for (node_t const *node = Node(state->head); node != nullptr; node = Node(node->next))
+      fn(static_cast<T const *>(&node->data), size_t(1));
+  }
+
+  /**
+   * Get begin iterator function.
+   * @return begin iterator
+   */
+  iterator_t begin(void) {
+    return iterator_t(Node(state->head), this);
+  }
+
+  /**
+   * Get end iterator function.
+   * @return end iterator
+   */
+  iterator_t end(void) {
+    return iterator_t(nullptr, this);
+  }
+
+  /**
+   * Get constant begin iterator function.
+   * @return constant begin iterator
+   */
+  const_iterator_t begin(void) const {
+    return const_iterator_t(Node(state->head), this);
+  }
+
+  /**
+   * Get constant end iterator function.
+   * @return constant end iterator
+   */
+  const_iterator_t end(void) const {
+    return const_iterator_t(nullptr, this);
+  }
+
+  /**
+   * Get constant begin iterator function.
+   * @return constant begin iterator
+   */
+  const_iterator_t cbegin(void) const {
+    return begin();
+  }
+
+  /**
+   * Get constant end iterator function.
+   * @return constant end iterator
+   */
+  const_iterator_t cend(void) const {
+    return end();
+  }
+};
+
+/**
+ * Operator<< for persistent deque and output stream.
+ * @tparam T deque elements type
+ * @param[in] stream output stream
+ * @param[in] deq deque to output
+ * @return reference to stream
+ */
+template <typename T>
+std::ostream &operator<<(std::ostream &stream, persistent_deque_t<T> const &deq) {
+  for (T const &data : deq)
+    stream << data << ", ";
+  return stream;
+}
+
+#endif /* __PERSISTENT_DEQUE_H_INCLUDED */
@@ -0,0 +1,1206 @@
+/**
+ * @file
+ * @brief Ring deque header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains bounded deque class with ring storage
+ */
+
+#pragma once
+
+#ifndef __RING_DEQUE_H_INCLUDED
+#define __RING_DEQUE_H_INCLUDED
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../allocator/allocator.h"
+#include "iterator_checks.h"
+
+/**
+ * @brief Ring deque overflow policy enum.
+ */
+enum class overflow_policy_t {
+  Reject,     ///< push to full deque throws, try push returns false
+  Overwrite,  ///< push to full deque removes element from opposite end
+  Block       ///< push to full deque waits for pop from another thread, try push returns false
+};
+
+/**
+ * @brief Ring deque implementation namespace.
+ */
+namespace ring_detail {
+  /**
+   * @brief Blocking ring deque synchronization struct.
+   * @tparam IsBlocking deque waits for free slots flag
+   */
+  template <bool IsBlocking>
+  struct sync_t {
+    mutable std::mutex mutex;          ///< deque state mutex
+    std::condition_variable notFull;   ///< free slot appearance condition
+  };
+
+  /**
+   * @brief Empty synchronization struct for not blocking ring deque.
+   */
+  template <>
+  struct sync_t<false> {
+  };
+}
+
+/**
+ * @brief Template bounded deque with ring storage class.
+ * @tparam T deque elements type
+ * @tparam RingSize maximal number of elements, power of 2 makes indexing cheaper
+ * @tparam Policy overflow policy
+ * @tparam Strategy allocation strategy type, 'alloc_strategy_t' means runtime strategy
+ *
+ * Deque on one contiguous ring of 'RingSize' slots allocated from strategy at construction,
+ * so pushes and pops never call strategy.
+ * Push to full deque is handled by overflow policy.
+ * With blocking policy element functions, size functions, Clear and ChangeAllocator lock deque,
+ * so producers and consumers may work on different threads.
+ * Iteration, indexing, copying and moving are never synchronized.
+ * With static strategy type deque is default constructible and strategy calls have no virtual dispatch,
+ * functions with strategy argument are available only with runtime strategy.
+ */
+template <typename T, size_t RingSize, overflow_policy_t Policy = overflow_policy_t::Reject, typename Strategy = alloc_strategy_t>
+class ring_deque_t : private ring_detail::sync_t<Policy == overflow_policy_t::Block> {
+  static_assert(RingSize > 0, "Ring size must be positive");
+
+private:
+  static constexpr bool isBlocking = Policy == overflow_policy_t::Block;  ///< deque waits for free slots flag
+  static constexpr size_t startPos = RingSize * (SIZE_MAX / RingSize / 2);  ///< first element position of empty deque
+
+  single_allocator_t<T, Strategy> allocator;  ///< allocator for ring
+  T *slots;                                   ///< ring storage, nullptr for moved deque until next push
+  size_t
+    first,                                    ///< position of first element, ring index is position modulo capacity
+    size;                                     ///< number of elements
+
+  /**
+   * Get element by position function.
+   * @param[in] pos element position
+   * @return pointer to element
+   */
+  T *Slot(size_t pos) const {
+    return slots + pos % RingSize;
+  }
+
+  /**
+   * Lock deque with blocking policy function.
+   * @return lock of deque mutex, empty lock for not blocking policy
+   */
+  std::unique_lock<std::mutex> Lock(void) const {
+    if constexpr (isBlocking)
+      return std::unique_lock<std::mutex>(this->mutex);
+    else
+      return std::unique_lock<std::mutex>();
+  }
+
+  /**
+   * Notify waiting pushes about free slots function.
+   * @param[in] all wake all pushes flag, otherwise one push is woken
+   */
+  void NotifyNotFull(bool all) {
+    if constexpr (isBlocking) {
+      if (all)
+        this->notFull.notify_all();
+      else
+        this->notFull.notify_one();
+    }
+  }
+
+  /**
+   * Get free slot for push by overflow policy function.
+   * @param[in] lock deque lock, released while push waits
+   * @param[in] atBack push to back flag, otherwise push to front
+   * @param[in] mayWait push may wait for free slot flag
+   * @return true if there is free slot, false if push has to be rejected
+   */
+  bool MakeRoom(std::unique_lock<std::mutex> &lock, bool atBack, bool mayWait) {
+    if (slots == nullptr)
+      slots = allocator.allocArrayRaw(RingSize);
+    if (size < RingSize)
+      return true;
+    if constexpr (Policy == overflow_policy_t::Overwrite) {
+      if (atBack)
+        EraseFront();
+      else
+        EraseBack();
+      return true;
+    }
+    else if constexpr (isBlocking) {
+      if (!mayWait)
+        return false;
+      this->notFull.wait(lock, [this] {
+        return size < RingSize;
+      });
+      return true;
+    }
+    else
+      return false;
+  }
+
+  /**
+   * Construct element in free slot function. Slot must be made by 'MakeRoom'.
+   * @tparam Args element constructor argument types
+   * @param[in] atBack push to back flag, otherwise push to front
+   * @param[in] constructorArgs element constructor arguments
+   * @return pointer to constructed element
+   */
+  template <typename... Args>
+  T *Construct(bool atBack, Args&&... constructorArgs) {
+    T *slot = new (Slot(atBack ? first + size : first - 1)) T(std::forward<Args>(constructorArgs)...);
+    if (!atBack)
+      first--;
+    size++;
+    return slot;
+  }
+
+  /**
+   * Make free slot by overflow policy and construct element in it function.
+   * With overwrite policy element for full deque is built before overwritten element is destroyed,
+   * so it may be built from overwritten element.
+   * @tparam Args element constructor argument types
+   * @param[in] lock deque lock, released while push waits
+   * @param[in] atBack push to back flag, otherwise push to front
+   * @param[in] mayWait push may wait for free slot flag
+   * @param[in] constructorArgs element constructor arguments
+   * @return pointer to constructed element, nullptr if push was rejected
+   */
+  template <typename... Args>
+  T *Push(std::unique_lock<std::mutex> &lock, bool atBack, bool mayWait, Args&&... constructorArgs) {
+    if constexpr (Policy == overflow_policy_t::Overwrite) {
+      if (size == RingSize) {
+        T data(std::forward<Args>(constructorArgs)...);
+        MakeRoom(lock, atBack, mayWait);
+        return Construct(atBack, std::move(data));
+      }
+    }
+    if (!MakeRoom(lock, atBack, mayWait))
+      return nullptr;
+    return Construct(atBack, std::forward<Args>(constructorArgs)...);
+  }
+
+  /**
+   * Remove last element function. Deque must be not empty.
+   */
+  void EraseBack(void) {
+    Slot(first + size - 1)->~T();
+    size--;
+  }
+
+  /**
+   * Remove first element function. Deque must be not empty.
+   */
+  void EraseFront(void) {
+    Slot(first)->~T();
+    first++;
+    size--;
+  }
+
+  /**
+   * Destroy elements and free ring function.
+   */
+  void FreeAll(void) {
+    if (slots == nullptr)
+      return;
+    for (size_t i = 0; i < size; i++)
+      Slot(first + i)->~T();
+    allocator.deallocArrayRaw(slots, RingSize);
+    slots = nullptr;
+    first = startPos;
+    size = 0;
+  }
+
+  /**
+   * Copy elements of another deque to empty deque with allocated ring function.
+   * Elements are destroyed if exception is thrown.
+   * @param[in] lhs deque to copy
+   */
+  void CopyElements(ring_deque_t const &lhs) {
+    first = startPos;
+    try {
+      for (; size < lhs.size; size++)
+        new (Slot(first + size)) T(*lhs.Slot(lhs.first + size));
+    }
+    catch (...) {
+      FreeAll();
+      throw;
+    }
+  }
+
+  /**
+   * @brief Ring deque iterator class.
+   * @tparam IsConst constant iterator flag
+   *
+   * Random access iterator, element is found by its position in ring.
+   * Iterators are invalidated by pops and overwrites of iterated elements.
+   * Dereference of end iterator and moving over deque bounds throw only with checked iterators (see DEQUE_CHECKED_ITERATORS).
+   */
+  template <bool IsConst>
+  class basic_iterator_t {
+    template <bool> friend class basic_iterator_t;
+
+  public:
+    using iterator_category = std::random_access_iterator_tag;                          ///< iterator category
+    using value_type = T;                                                               ///< element type
+    using difference_type = std::ptrdiff_t;                                             ///< iterators distance type
+    using pointer = typename std::conditional<IsConst, T const *, T *>::type;           ///< element pointer type
+    using reference = typename std::conditional<IsConst, T const &, T &>::type;         ///< element reference type
+
+  private:
+    using deque_ptr_t = typename std::conditional<IsConst, ring_deque_t const *, ring_deque_t *>::type;  ///< iterated deque pointer type
+
+    deque_ptr_t deq;  ///< iterated deque
+    size_t pos;       ///< position of current element
+
+  public:
+    /**
+     * Default constructor. Iterator is singular.
+     */
+    basic_iterator_t(void) : deq(nullptr), pos(0) {
+    }
+
+    /**
+     * Constructor by deque and position.
+     * @param[in] d deque for iterator
+     * @param[in] p position of element
+     */
+    basic_iterator_t(deque_ptr_t d, size_t p) : deq(d), pos(p) {
+    }
+
+    /**
+     * Conversion constructor from modifying iterator to constant iterator.
+     * @tparam WasConst converted iterator constant flag
+     * @param[in] lhs iterator to convert
+     */
+    template <bool WasConst, typename = typename std::enable_if<IsConst && !WasConst>::type>
+    basic_iterator_t(basic_iterator_t<WasConst> const &lhs) : deq(lhs.deq), pos(lhs.pos) {
+    }
+
+    /**
+     * Equality operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator==(basic_iterator_t<IsConst1> const &lhs) const {
+      return pos == lhs.pos;
+    }
+
+    /**
+     * Inequality operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator!=(basic_iterator_t<IsConst1> const &lhs) const {
+      return pos != lhs.pos;
+    }
+
+    /**
+     * Less operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator<(basic_iterator_t<IsConst1> const &lhs) const {
+      return pos < lhs.pos;
+    }
+
+    /**
+     * Greater operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator>(basic_iterator_t<IsConst1> const &lhs) const {
+      return pos > lhs.pos;
+    }
+
+    /**
+     * Less or equal operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator<=(basic_iterator_t<IsConst1> const &lhs) const {
+      return pos <= lhs.pos;
+    }
+
+    /**
+     * Greater or equal operator.
+     * @tparam IsConst1 compared iterator constant flag
+     * @param[in] lhs iterator to compare
+     */
+    template <bool IsConst1>
+    bool operator>=(basic_iterator_t<IsConst1> const &lhs) const {
+      return pos >= lhs.pos;
+    }
+
+    /**
+     * Operator * to provide pointer semantics.
+     * @return data reference
+     */
+    reference operator*(void) const {
+#if DEQUE_CHECKED_ITERATORS
+      if (pos == deq->first + deq->size)
+        throw std::exception("Try to use end iterator");
+#endif /* DEQUE_CHECKED_ITERATORS */
+      return *deq->Slot(pos);
+    }
+
+    /**
+     * Operator -> to provide pointer semantics.
+     * @return data pointer
+     */
+    pointer operator->(void) const {
+      return &**this;
+    }
+
+    /**
+     * Operator [] to access element by offset.
+     * @param[in] offset element offset from iterator
+     * @return data reference
+     */
+    reference operator[](difference_type offset) const {
+      return *deq->Slot(pos + offset);
+    }
+
+    /**
+     * Prefix increment.
+     * @return current iterator value
+     */
+    basic_iterator_t &operator++(void) {
+#if DEQUE_CHECKED_ITERATORS
+      if (pos == deq->first + deq->size)
+        throw std::exception("Try to use end iterator");
+#endif /* DEQUE_CHECKED_ITERATORS */
+      pos++;
+      return *this;
+    }
+
+    /**
+     * Postfix increment.
+     * @param[in] unusedInteger unused argument
+     * @return previous iterator value
+     */
+    basic_iterator_t operator++(int unusedInteger) {
+      basic_iterator_t tmp{*this};
+      ++*this;
+      return tmp;
+    }
+
+    /**
+     * Prefix decrement.
+     * @return current iterator value
+     */
+    basic_iterator_t &operator--(void) {
+#if DEQUE_CHECKED_ITERATORS
+      if (pos == deq->first)
+        throw std::exception("Try to move before begin iterator");
+#endif /* DEQUE_CHECKED_ITERATORS */
+      pos--;
+      return *this;
+    }
+
+    /**
+     * Postfix decrement.
+     * @param[in] unusedInteger unused argument
+     * @return previous iterator value
+     */
+    basic_iterator_t operator--(int unusedInteger) {
+      basic_iterator_t tmp{*this};
+      --*this;
+      return tmp;
+    }
+
+    /**
+     * Move iterator forward operator.
+     * @param[in] offset number of elements to move
+     * @return current iterator value
+     */
+    basic_iterator_t &operator+=(difference_type offset) {
+      pos += offset;
+      return *this;
+    }
+
+    /**
+     * Move iterator backward operator.
+     * @param[in] offset number of elements to move
+     * @return current iterator value
+     */
+    basic_iterator_t &operator-=(difference_type offset) {
+      pos -= offset;
+      return *this;
+    }
+
+    /**
+     * Get moved forward iterator operator.
+     * @param[in] offset number of elements to move
+     * @return moved iterator
+     */
+    basic_iterator_t operator+(difference_type offset) const {
+      return basic_iterator_t(deq, pos + offset);
+    }
+
+    /**
+     * Get moved backward iterator operator.
+     * @param[in] offset number of elements to move
+     * @return moved iterator
+     */
+    basic_iterator_t operator-(difference_type offset) const {
+      return basic_iterator_t(deq, pos - offset);
+    }
+
+    /**
+     * Get distance between iterators operator.
+     * @tparam IsConst1 other iterator constant flag
+     * @param[in] lhs other iterator
+     * @return number of elements from other iterator to this one
+     */
+    template <bool IsConst1>
+    difference_type operator-(basic_iterator_t<IsConst1> const &lhs) const {
+      return static_cast<difference_type>(pos - lhs.pos);
+    }
+
+    /**
+     * Get moved forward iterator operator with offset first.
+     * @param[in] offset number of elements to move
+     * @param[in] it iterator to move
+     * @return moved iterator
+     */
+    friend basic_iterator_t operator+(difference_type offset, basic_iterator_t const &it) {
+      return it + offset;
+    }
+  };
+
+public:
+  using iterator_t = basic_iterator_t<false>;       ///< modifying iterator type
+  using const_iterator_t = basic_iterator_t<true>;  ///< constant iterator type
+
+  /**
+   * Default constructor. Available only for static strategy.
+   */
+  ring_deque_t(void) : slots(allocator.allocArrayRaw(RingSize)), first(startPos), size(0) {
+  }
+
+  /**
+   * Constructor with strategy function.
+   * @param[in] strategy allocation strategy
+   */
+  ring_deque_t(std::shared_ptr<alloc_strategy_t> const &strategy) :
+    allocator(strategy), slots(allocator.allocArrayRaw(RingSize)), first(startPos), size(0) {
+  }
+
+  /**
+   * Copy constructor.
+   * @param[in] lhs instance to copy
+   */
+  ring_deque_t(ring_deque_t const &lhs) :
+    allocator(lhs.allocator), slots(allocator.allocArrayRaw(RingSize)), first(startPos), size(0) {
+    CopyElements(lhs);
+  }
+
+  /**
+   * Copy constructor with strategy function.
+   * @param[in] lhs instance to copy
+   * @param[in] strategy allocation strategy
+   */
+  ring_deque_t(ring_deque_t const &lhs, std::shared_ptr<alloc_strategy_t> const &strategy) :
+    allocator(strategy), slots(allocator.allocArrayRaw(RingSize)), first(startPos), size(0) {
+    CopyElements(lhs);
+  }
+
+  /**
+   * Move constructor. Moved deque keeps strategy and allocates new ring on next push.
+   * @param[in] rhs instance to copy
+   */
+  ring_deque_t(ring_deque_t &&rhs) :
+    allocator(rhs.allocator), slots(rhs.slots), first(rhs.first), size(rhs.size) {
+    rhs.slots = nullptr;
+    rhs.first = startPos;
+    rhs.size = 0;
+  }
+
+  /**
+   * Copy operator =.
+   * With equal allocators ring is reused, otherwise it is freed and allocated from strategy of copied deque.
+   * @param[in] lhs instance to copy
+   */
+  void operator=(ring_deque_t const &lhs) {
+    if (this == &lhs)
+      return;
+    if (slots != nullptr && allocator == lhs.allocator) {
+      for (size_t i = 0; i < size; i++)
+        Slot(first + i)->~T();
+      size = 0;
+      CopyElements(lhs);
+      return;
+    }
+    FreeAll();
+    allocator = lhs.allocator;
+    slots = allocator.allocArrayRaw(RingSize);
+    CopyElements(lhs);
+  }
+
+  /**
+   * Copy with another allocator.
+   * @param[in] lhs instance to copy
+   * @param[in] strategy allocation strategy for deque
+   */
+  void Copy(ring_deque_t const &lhs, std::shared_ptr<alloc_strategy_t> const &strategy) {
+    FreeAll();
+    allocator = single_allocator_t<T, Strategy>(strategy);
+    slots = allocator.allocArrayRaw(RingSize);
+    CopyElements(lhs);
+  }
+
+  /**
+   * Move operator =. Moved deque keeps strategy and allocates new ring on next push.
+   * @param[in] rhs rValue instance to copy
+   */
+  void operator=(ring_deque_t &&rhs) {
+    if (this == &rhs)
+      return;
+    FreeAll();
+    allocator = rhs.allocator;
+    slots = rhs.slots;
+    first = rhs.first;
+    size = rhs.size;
+    rhs.slots = nullptr;
+    rhs.first = startPos;
+    rhs.size = 0;
+  }
+
+  /**
+   * Destructor.
+   */
+  ~ring_deque_t(void) {
+    FreeAll();
+  }
+
+  /**
+   * Construct element back in place function.
+   * Full deque is handled by overflow policy, rejected push throws.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   * @return reference to constructed element
+   */
+  template <typename... Args>
+  T &EmplaceBack(Args&&... constructorArgs) {
+    std::unique_lock<std::mutex> lock = Lock();
+    T *slot = Push(lock, true, true, std::forward<Args>(constructorArgs)...);
+    if (slot == nullptr)
+      throw std::exception("Ring deque is full");
+    return *slot;
+  }
+
+  /**
+   * Construct element front in place function.
+   * Full deque is handled by overflow policy, rejected push throws.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   * @return reference to constructed element
+   */
+  template <typename... Args>
+  T &EmplaceFront(Args&&... constructorArgs) {
+    std::unique_lock<std::mutex> lock = Lock();
+    T *slot = Push(lock, false, true, std::forward<Args>(constructorArgs)...);
+    if (slot == nullptr)
+      throw std::exception("Ring deque is full");
+    return *slot;
+  }
+
+  /**
+   * Try to construct element back in place function. Does not throw or wait on full deque.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   * @return true if element was pushed, false if push was rejected
+   */
+  template <typename... Args>
+  bool TryEmplaceBack(Args&&... constructorArgs) {
+    std::unique_lock<std::mutex> lock = Lock();
+    return Push(lock, true, false, std::forward<Args>(constructorArgs)...) != nullptr;
+  }
+
+  /**
+   * Try to construct element front in place function. Does not throw or wait on full deque.
+   * @tparam Args element constructor argument types
+   * @param[in] constructorArgs element constructor arguments
+   * @return true if element was pushed, false if push was rejected
+   */
+  template <typename... Args>
+  bool TryEmplaceFront(Args&&... constructorArgs) {
+    std::unique_lock<std::mutex> lock = Lock();
+    return Push(lock, false, false, std::forward<Args>(constructorArgs)...) != nullptr;
+  }
+
+  /**
+   * Push element back function.
+   * @param[in] data data to push
+   */
+  void PushBack(T const &data) {
+    EmplaceBack(data);
+  }
+
+  /**
+   * Push element back with move function.
+   * @param[in] data data to push
+   */
+  void PushBack(T &&data) {
+    EmplaceBack(std::move(data));
+  }
+
+  /**
+   * Push element front function.
+   * @param[in] data data to push
+   */
+  void PushFront(T const &data) {
+    EmplaceFront(data);
+  }
+
+  /**
+   * Push element front with move function.
+   * @param[in] data data to push
+   */
+  void PushFront(T &&data) {
+    EmplaceFront(std::move(data));
+  }
+
+  /**
+   * Try to push element back function. Does not throw or wait on full deque.
+   * @param[in] data data to push
+   * @return true if element was pushed, false if push was rejected
+   */
+  bool TryPushBack(T const &data) {
+    return TryEmplaceBack(data);
+  }
+
+  /**
+   * Try to push element back with move function. Does not throw or wait on full deque.
+   * @param[in] data data to push
+   * @return true if element was pushed, false if push was rejected
+   */
+  bool TryPushBack(T &&data) {
+    return TryEmplaceBack(std::move(data));
+  }
+
+  /**
+   * Try to push element front function. Does not throw or wait on full deque.
+   * @param[in] data data to push
+   * @return true if element was pushed, false if push was rejected
+   */
+  bool TryPushFront(T const &data) {
+    return TryEmplaceFront(data);
+  }
+
+  /**
+   * Try to push element front with move function. Does not throw or wait on full deque.
+   * @param[in] data data to push
+   * @return true if element was pushed, false if push was rejected
+   */
+  bool TryPushFront(T &&data) {
+    return TryEmplaceFront(std::move(data));
+  }
+
+  /**
+   * Push range of elements back function.
+   * Elements are pushed one by one with overflow policy,
+   * with reject policy forward iterator range which does not fit is rejected before any push.
+   * @tparam InputIt range iterator type
+   * @param[in] rangeFirst range begin
+   * @param[in] rangeLast range end
+   */
+  template <typename InputIt>
+  void PushBack(InputIt rangeFirst, InputIt rangeLast) {
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (Policy == overflow_policy_t::Reject && std::is_base_of<std::forward_iterator_tag, category>::value)
+      if (Size() + static_cast<size_t>(std::distance(rangeFirst, rangeLast)) > RingSize)
+        throw std::exception("Ring deque is full");
+    for (; rangeFirst != rangeLast; ++rangeFirst)
+      PushBack(*rangeFirst);
+  }
+
+  /**
+   * Push list of elements back function.
+   * @param[in] list elements to push
+   */
+  void PushBack(std::initializer_list<T> list) {
+    PushBack(list.begin(), list.end());
+  }
+
+  /**
+   * Push range of elements front function.
+   * Range order is kept, so range first element becomes deque first element.
+   * Elements are pushed one by one from range end with overflow policy,
+   * with reject policy forward iterator range which does not fit is rejected before any push.
+   * @tparam InputIt range iterator type
+   * @param[in] rangeFirst range begin
+   * @param[in] rangeLast range end
+   */
+  template <typename InputIt>
+  void PushFront(InputIt rangeFirst, InputIt rangeLast) {
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (!std::is_base_of<std::bidirectional_iterator_tag, category>::value) {
+      std::vector<T> tmp(rangeFirst, rangeLast);
+      PushFront(std::make_move_iterator(tmp.begin()), std::make_move_iterator(tmp.end()));
+    }
+    else {
+      if constexpr (Policy == overflow_policy_t::Reject)
+        if (Size() + static_cast<size_t>(std::distance(rangeFirst, rangeLast)) > RingSize)
+          throw std::exception("Ring deque is full");
+      while (rangeLast != rangeFirst)
+        PushFront(*--rangeLast);
+    }
+  }
+
+  /**
+   * Push list of elements front function.
+   * @param[in] list elements to push
+   */
+  void PushFront(std::initializer_list<T> list) {
+    PushFront(list.begin(), list.end());
+  }
+
+  /**
+   * Pop several elements back function.
+   * Elements are written in pop order.
+   * @tparam OutputIt output iterator type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @return number of poped elements
+   */
+  template <typename OutputIt>
+  size_t PopBack(size_t count, OutputIt out) {
+    std::unique_lock<std::mutex> lock = Lock();
+    size_t poped = 0;
+    try {
+      for (; poped < count && size != 0; poped++) {
+        *out = std::move(*Slot(first + size - 1));
+        ++out;
+        EraseBack();
+      }
+    }
+    catch (...) {
+      NotifyNotFull(true);
+      throw;
+    }
+    NotifyNotFull(true);
+    return poped;
+  }
+
+  /**
+   * Pop several elements front function.
+   * Elements are written in pop order.
+   * @tparam OutputIt output iterator type
+   * @param[in] count maximal number of elements to pop
+   * @param[in] out output iterator for poped elements
+   * @return number of poped elements
+   */
+  template <typename OutputIt>
+  size_t PopFront(size_t count, OutputIt out) {
+    std::unique_lock<std::mutex> lock = Lock();
+    size_t poped = 0;
+    try {
+      for (; poped < count && size != 0; poped++) {
+        *out = std::move(*Slot(first));
+        ++out;
+        EraseFront();
+      }
+    }
+    catch (...) {
+      NotifyNotFull(true);
+      throw;
+    }
+    NotifyNotFull(true);
+    return poped;
+  }
+
+  /**
+   * Pop element back function.
+   * @return poped element
+   */
+  T PopBack(void) {
+    std::unique_lock<std::mutex> lock = Lock();
+    if (size == 0)
+      throw std::exception("Empty list");
+    T data = std::move(*Slot(first + size - 1));
+    EraseBack();
+    NotifyNotFull(false);
+    return data;
+  }
+
+  /**
+   * Pop element front function.
+   * @return poped element
+   */
+  T PopFront(void) {
+    std::unique_lock<std::mutex> lock = Lock();
+    if (size == 0)
+      throw std::exception("Empty list");
+    T data = std::move(*Slot(first));
+    EraseFront();
+    NotifyNotFull(false);
+    return data;
+  }
+
+  /**
+   * Try to pop element back function. Does not throw on empty deque.
+   * @param[out] data poped element, assigned with move
+   * @return true if element was poped, false if deque is empty
+   */
+  bool TryPopBack(T &data) {
+    std::unique_lock<std::mutex> lock = Lock();
+    if (size == 0)
+      return false;
+    data = std::move(*Slot(first + size - 1));
+    EraseBack();
+    NotifyNotFull(false);
+    return true;
+  }
+
+  /**
+   * Try to pop element front function. Does not throw on empty deque.
+   * @param[out] data poped element, assigned with move
+   * @return true if element was poped, false if deque is empty
+   */
+  bool TryPopFront(T &data) {
+    std::unique_lock<std::mutex> lock = Lock();
+    if (size == 0)
+      return false;
+    data = std::move(*Slot(first));
+    EraseFront();
+    NotifyNotFull(false);
+    return true;
+  }
+
+  /**
+   * Try to pop element back function. Does not throw on empty deque.
+   * @return poped element, empty if deque is empty
+   */
+  std::optional<T> TryPopBack(void) {
+    std::unique_lock<std::mutex> lock = Lock();
+    if (size == 0)
+      return std::nullopt;
+    std::optional<T> data(std::move(*Slot(first + size - 1)));
+    EraseBack();
+    NotifyNotFull(false);
+    return data;
+  }
+
+  /**
+   * Try to pop element front function. Does not throw on empty deque.
+   * @return poped element, empty if deque is empty
+   */
+  std::optional<T> TryPopFront(void) {
+    std::unique_lock<std::mutex> lock = Lock();
+    if (size == 0)
+      return std::nullopt;
+    std::optional<T> data(std::move(*Slot(first)));
+    EraseFront();
+    NotifyNotFull(false);
+    return data;
+  }
+
+  /**
+   * Is empty check function.
+   * @return true if deque is empty, false - otherwise
+   */
+  bool IsEmpty(void) const {
+    std::unique_lock<std::mutex> lock = Lock();
+    return size == 0;
+  }
+
+  /**
+   * Is full check function.
+   * @return true if next push is handled by overflow policy, false - otherwise
+   */
+  bool IsFull(void) const {
+    std::unique_lock<std::mutex> lock = Lock();
+    return size == RingSize;
+  }
+
+  /**
+   * Get number of elements function.
+   * @return number of elements
+   */
+  size_t Size(void) const {
+    std::unique_lock<std::mutex> lock = Lock();
+    return size;
+  }
+
+  /**
+   * Get maximal number of elements function.
+   * @return number of elements
+   */
+  size_t Capacity(void) const {
+    return RingSize;
+  }
+
+  /**
+   * Reserve storage for elements function. Ring is allocated at construction, so nothing is done.
+   * @param[in] count number of elements deque must hold, must not exceed capacity
+   */
+  void Reserve(size_t count) {
+    if (count > RingSize)
+      throw std::exception("Ring deque capacity is fixed");
+  }
+
+  /**
+   * Return unused storage to strategy function. Ring is kept until destruction, so nothing is done.
+   */
+  void ShrinkToFit(void) {
+  }
+
+  /**
+   * Clear deque function. Ring is kept.
+   */
+  void Clear(void) {
+    std::unique_lock<std::mutex> lock = Lock();
+    for (size_t i = 0; i < size; i++)
+      Slot(first + i)->~T();
+    first = startPos;
+    size = 0;
+    NotifyNotFull(true);
+  }
+
+  /**
+   * Get element by index function. Index is not checked.
+   * @param[in] index element index from deque beginning
+   * @return reference to element
+   */
+  T &operator[](size_t index) {
+    return *Slot(first + index);
+  }
+
+  /**
+   * Get constant element by index function. Index is not checked.
+   * @param[in] index element index from deque beginning
+   * @return constant reference to element
+   */
+  T const &operator[](size_t index) const {
+    return *Slot(first + index);
+  }
+
+  /**
+   * Get element by index with check function.
+   * @param[in] index element index from deque beginning
+   * @return reference to element
+   */
+  T &At(size_t index) {
+    if (index >= size)
+      throw std::exception("Index out of range");
+    return *Slot(first + index);
+  }
+
+  /**
+   * Get constant element by index with check function.
+   * @param[in] index element index from deque beginning
+   * @return constant reference to element
+   */
+  T const &At(size_t index) const {
+    if (index >= size)
+      throw std::exception("Index out of range");
+    return *Slot(first + index);
+  }
+
+  /**
+   * Change allocator strategy function.
+   * If deque is the only owner of its strategy and new strategy absorbs its memory, ring is kept without copying.
+   * Otherwise elements are moved to ring allocated from new strategy and old ring is freed.
+   * @param[in] strategy allocation strategy for deque
+   */
+  void ChangeAllocator(std::shared_ptr<alloc_strategy_t> const &strategy) {
+    std::unique_lock<std::mutex> lock = Lock();
+    if (allocator.migrate(strategy))
+      return;
+    single_allocator_t<T, Strategy> newAllocator(strategy);
+    if (slots == nullptr) {
+      allocator = newAllocator;
+      return;
+    }
+    T *newSlots = newAllocator.allocArrayRaw(RingSize);
+    size_t moved = 0;
+    try {
+      for (; moved < size; moved++)
+        new (newSlots + (startPos + moved) % RingSize) T(std::move(*Slot(first + moved)));
+    }
+    catch (...) {
+      for (size_t i = 0; i < moved; i++)
+        newSlots[(startPos + i) % RingSize].~T();
+      newAllocator.deallocArrayRaw(newSlots, RingSize);
+      throw;
+    }
+    for (size_t i = 0; i < size; i++)
+      Slot(first + i)->~T();
+    allocator.deallocArrayRaw(slots, RingSize);
+    allocator = newAllocator;
+    slots = newSlots;
+    first = startPos;
+  }
+
+  /**
+   * Split deque into ranges of neighbouring elements function.
+   * Ranges have equal number of elements up to one.
+   * @param[in] numOfParts maximal number of ranges
+   * @return ranges in deque order, no empty ranges
+   */
+  std::vector<std::pair<iterator_t, iterator_t>> Partition(size_t numOfParts) {
+    std::vector<std::pair<iterator_t, iterator_t>> parts;
+    numOfParts = std::min(std::max<size_t>(numOfParts, 1), size);
+    for (size_t part = 0; part < numOfParts; part++)
+      parts.emplace_back(iterator_t(this, first + size * part / numOfParts), iterator_t(this, first + size * (part + 1) / numOfParts));
+    return parts;
+  }
+
+  /**
+   * Split constant deque into ranges of neighbouring elements function.
+   * Ranges have equal number of elements up to one.
+   * @param[in] numOfParts maximal number of ranges
+   * @return ranges in deque order, no empty ranges
+   */
+  std::vector<std::pair<const_iterator_t, const_iterator_t>> Partition(size_t numOfParts) const {
+    std::vector<std::pair<const_iterator_t, const_iterator_t>> parts;
+    numOfParts = std::min(std::max<size_t>(numOfParts, 1), size);
+    for (size_t part = 0; part < numOfParts; part++)
+      parts.emplace_back(const_iterator_t(this, first + size * part / numOfParts), const_iterator_t(this, first + size * (part + 1) / numOfParts));
+    return parts;
+  }
+
+  /**
+   * Call function for every element function.
+   * Elements are visited in order by plain loops over ring without iterator checks.
+   * @tparam Fn function type, called with element reference
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEach(Fn fn) {
+    ForEachBlock([&fn](T *data, size_t count) {
+      for (size_t i = 0; i < count; i++)
+        fn(data[i]);
+    });
+  }
+
+  /**
+   * Call function for every constant element function.
+   * Elements are visited in order by plain loops over ring without iterator checks.
+   * @tparam Fn function type, called with constant element reference
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEach(Fn fn) const {
+    ForEachBlock([&fn](T const *data, size_t count) {
+      for (size_t i = 0; i < count; i++)
+        fn(data[i]);
+    });
+  }
+
+  /**
+   * Call function for every contiguous span of elements function.
+   * Elements lie in one or two spans: from first element to ring end and from ring beginning.
+   * @tparam Fn function type, called with pointer to first span element and number of span elements
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEachBlock(Fn fn) {
+    for (size_t pos = first, last = first + size; pos < last;) {
+      size_t count = std::min(RingSize - pos % RingSize, last - pos);
+      fn(Slot(pos), count);
+      pos += count;
+    }
+  }
+
+  /**
+   * Call function for every contiguous span of constant elements function.
+   * Elements lie in one or two spans: from first element to ring end and from ring beginning.
+   * @tparam Fn function type, called with pointer to first constant span element and number of span elements
+   * @param[in] fn function to call
+   */
+  template <typename Fn>
+  void ForEachBlock(Fn fn) const {
+    for (size_t pos = first, last = first + size; pos < last;) {
+      size_t count = std::min(RingSize - pos % RingSize, last - pos);
+      fn(static_cast<T const *>(Slot(pos)), count);
+      pos += count;
+    }
+  }
+
+  /**
+   * Get begin iterator function.
+   * @return begin iterator
+   */
+  iterator_t begin(void) {
+    return iterator_t(this, first);
+  }
+
+  /**
+   * Get end iterator function.
+   * @return end iterator
+   */
+  iterator_t end(void) {
+    return iterator_t(this, first + size);
+  }
+
+  /**
+   * Get constant begin iterator function.
+   * @return constant begin iterator
+   */
+  const_iterator_t begin(void) const {
+    return const_iterator_t(this, first);
+  }
+
+  /**
+   * Get constant end iterator function.
+   * @return constant end iterator
+   */
+  const_iterator_t end(void) const {
+    return const_iterator_t(this, first + size);
+  }
+
+  /**
+   * Get constant begin iterator function.
+   * @return constant begin iterator
+   */
+  const_iterator_t cbegin(void) const {
+    return begin();
+  }
+
+  /**
+   * Get constant end iterator function.
+   * @return constant end iterator
+   */
+  const_iterator_t cend(void) const {
+    return end();
+  }
+};
+
+/**
+ * Operator<< for ring deque and output stream.
+ * @tparam T deque elements type
+ * @tparam RingSize maximal number of elements
+ * @tparam Policy overflow policy
+ * @tparam Strategy allocation strategy type
+ * @param[in] stream output stream
+ * @param[in] deq deque to output
+ * @return reference to stream
+ */
+template <typename T, size_t RingSize, overflow_policy_t Policy, typename Strategy>
+std::ostream &operator<<(std::ostream &stream, ring_deque_t<T, RingSize, Policy, Strategy> const &deq) {
+  for (T const &data : deq)
+    stream << data << ", ";
+  return stream;
+}
+
+#endif /* __RING_DEQUE_H_INCLUDED */
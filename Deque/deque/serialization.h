@@ -0,0 +1,516 @@
+/**
+ * @file
+ * @brief Deque serialization header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains binary serialization of deques to streams and raw buffers
+ */
+
+#pragma once
+
+#ifndef __SERIALIZATION_H_INCLUDED
+#define __SERIALIZATION_H_INCLUDED
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <istream>
+#include <iterator>
+#include <new>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+/**
+ * @brief Element serializer struct.
+ * @tparam T element type
+ *
+ * Elements of trivially copyable types are written as raw bytes, deque blocks are written at once.
+ * Other types need specialization with the same members, writers have 'Write(void const *data, size_t numOfBytes)'
+ * and readers have 'Read(void *data, size_t numOfBytes)' functions which throw on failure.
+ */
+template <typename T>
+struct serializer_t {
+  static_assert(std::is_trivially_copyable<T>::value, "Element type needs serializer_t specialization");
+
+  static constexpr bool isBulk = true;                 ///< elements are raw bytes flag
+  static constexpr std::uint32_t format = sizeof(T);   ///< element format tag checked on reading
+
+  /**
+   * Get serialized element size function.
+   * @param[in] data element
+   * @return number of bytes
+   */
+  static size_t Size(T const &data) {
+    return sizeof(T);
+  }
+
+  /**
+   * Write element function.
+   * @tparam Writer writer type
+   * @param[in] writer writer to write to
+   * @param[in] data element to write
+   */
+  template <typename Writer>
+  static void Write(Writer &writer, T const &data) {
+    writer.Write(&data, sizeof(T));
+  }
+
+  /**
+   * Read element function.
+   * @tparam Reader reader type
+   * @param[in] reader reader to read from
+   * @return read element
+   */
+  template <typename Reader>
+  static T Read(Reader &reader) {
+    alignas(T) unsigned char storage[sizeof(T)];
+    reader.Read(storage, sizeof(T));
+    return *std::launder(reinterpret_cast<T *>(storage));
+  }
+};
+
+/**
+ * @brief String serializer struct.
+ * @tparam CharT string character type
+ * @tparam Traits string character traits type
+ * @tparam Alloc string allocator type
+ *
+ * String is written as 64-bit length followed by characters.
+ * Characters are read by chunks, so string grows only with really read data whatever length is written.
+ */
+template <typename CharT, typename Traits, typename Alloc>
+struct serializer_t<std::basic_string<CharT, Traits, Alloc>> {
+  using string_t = std::basic_string<CharT, Traits, Alloc>;  ///< string type
+
+  static constexpr bool isBulk = false;                                   ///< elements are raw bytes flag
+  static constexpr std::uint32_t format = 0x80000000u | sizeof(CharT);   ///< element format tag checked on reading
+  static constexpr size_t chunkSize = std::max<size_t>(1, 4096 / sizeof(CharT));  ///< number of characters read at once
+
+  /**
+   * Get serialized element size function.
+   * @param[in] data element
+   * @return number of bytes
+   */
+  static size_t Size(string_t const &data) {
+    return sizeof(std::uint64_t) + data.size() * sizeof(CharT);
+  }
+
+  /**
+   * Write element function.
+   * @tparam Writer writer type
+   * @param[in] writer writer to write to
+   * @param[in] data element to write
+   */
+  template <typename Writer>
+  static void Write(Writer &writer, string_t const &data) {
+    std::uint64_t length = data.size();
+    writer.Write(&length, sizeof(length));
+    writer.Write(data.data(), data.size() * sizeof(CharT));
+  }
+
+  /**
+   * Read element function.
+   * @tparam Reader reader type
+   * @param[in] reader reader to read from
+   * @return read element
+   */
+  template <typename Reader>
+  static string_t Read(Reader &reader) {
+    std::uint64_t length;
+    reader.Read(&length, sizeof(length));
+    string_t data;
+    while (length != 0) {
+      size_t oldSize = data.size(), chunk = static_cast<size_t>(std::min<std::uint64_t>(length, chunkSize));
+      data.resize(oldSize + chunk);
+      reader.Read(&data[oldSize], chunk * sizeof(CharT));
+      length -= chunk;
+    }
+    return data;
+  }
+};
+
+/**
+ * @brief Serialization implementation namespace.
+ */
+namespace serialization_detail {
+  static constexpr std::uint32_t magic = 0x42514544;  ///< serialized deque mark, "DEQB" in little endian
+  static constexpr size_t stagingSize = 4096;         ///< number of bytes gathered before one stream call
+
+  /**
+   * @brief Serialized deque header struct.
+   */
+  struct header_t {
+    std::uint32_t
+      mark,          ///< serialized deque mark
+      format;        ///< element format tag
+    std::uint64_t
+      count;         ///< number of elements
+  };
+
+  /**
+   * @brief Output stream writer class.
+   */
+  class stream_writer_t {
+  private:
+    std::ostream &stream;  ///< stream to write to
+
+  public:
+    static constexpr bool isBuffer = false;  ///< writes go to memory without calls flag
+
+    /**
+     * Constructor.
+     * @param[in] outStream stream to write to
+     */
+    explicit stream_writer_t(std::ostream &outStream) : stream(outStream) {
+    }
+
+    /**
+     * Write bytes function.
+     * @param[in] data bytes to write
+     * @param[in] numOfBytes number of bytes
+     */
+    void Write(void const *data, size_t numOfBytes) {
+      if (!stream.write(static_cast<char const *>(data), static_cast<std::streamsize>(numOfBytes)))
+        throw std::exception("Stream write failed");
+    }
+  };
+
+  /**
+   * @brief Raw buffer writer class.
+   */
+  class buffer_writer_t {
+  private:
+    unsigned char
+      *pos,          ///< next byte to write
+      *end;          ///< buffer end
+
+  public:
+    static constexpr bool isBuffer = true;  ///< writes go to memory without calls flag
+
+    /**
+     * Constructor.
+     * @param[in] buffer buffer to write to
+     * @param[in] bufferSize number of buffer bytes
+     */
+    buffer_writer_t(void *buffer, size_t bufferSize) :
+      pos(static_cast<unsigned char *>(buffer)), end(static_cast<unsigned char *>(buffer) + bufferSize) {
+    }
+
+    /**
+     * Write bytes function.
+     * @param[in] data bytes to write
+     * @param[in] numOfBytes number of bytes
+     */
+    void Write(void const *data, size_t numOfBytes) {
+      if (numOfBytes > static_cast<size_t>(end - pos))
+        throw std::exception("Buffer is too small");
+      if (numOfBytes != 0)
+        std::memcpy(pos, data, numOfBytes);
+      pos += numOfBytes;
+    }
+
+    /**
+     * Get next byte to write function.
+     * @return pointer to byte
+     */
+    unsigned char *Pos(void) const {
+      return pos;
+    }
+  };
+
+  /**
+   * @brief Input stream reader class.
+   */
+  class stream_reader_t {
+  private:
+    std::istream &stream;  ///< stream to read from
+
+  public:
+    /**
+     * Constructor.
+     * @param[in] inStream stream to read from
+     */
+    explicit stream_reader_t(std::istream &inStream) : stream(inStream) {
+    }
+
+    /**
+     * Read bytes function.
+     * @param[out] data storage for read bytes
+     * @param[in] numOfBytes number of bytes
+     */
+    void Read(void *data, size_t numOfBytes) {
+      if (!stream.read(static_cast<char *>(data), static_cast<std::streamsize>(numOfBytes)))
+        throw std::exception("Unexpected end of serialized data");
+    }
+  };
+
+  /**
+   * @brief Raw buffer reader class.
+   */
+  class buffer_reader_t {
+  private:
+    unsigned char const
+      *pos,          ///< next byte to read
+      *end;          ///< buffer end
+
+  public:
+    /**
+     * Constructor.
+     * @param[in] buffer buffer to read from
+     * @param[in] bufferSize number of buffer bytes
+     */
+    buffer_reader_t(void const *buffer, size_t bufferSize) :
+      pos(static_cast<unsigned char const *>(buffer)), end(static_cast<unsigned char const *>(buffer) + bufferSize) {
+    }
+
+    /**
+     * Read bytes function.
+     * @param[out] data storage for read bytes
+     * @param[in] numOfBytes number of bytes
+     */
+    void Read(void *data, size_t numOfBytes) {
+      if (numOfBytes > static_cast<size_t>(end - pos))
+        throw std::exception("Unexpected end of serialized data");
+      if (numOfBytes != 0)
+        std::memcpy(data, pos, numOfBytes);
+      pos += numOfBytes;
+    }
+
+    /**
+     * Get next byte to read function.
+     * @return pointer to byte
+     */
+    unsigned char const *Pos(void) const {
+      return pos;
+    }
+  };
+
+  /**
+   * Get deque element type.
+   * @tparam Deque deque type
+   */
+  template <typename Deque>
+  using element_t = typename std::iterator_traits<typename Deque::const_iterator_t>::value_type;
+
+  /**
+   * Write deque with header function.
+   * Raw byte elements are written by deque blocks, small blocks are gathered before stream calls.
+   * @tparam Writer writer type
+   * @tparam Deque deque type
+   * @param[in] writer writer to write to
+   * @param[in] deq deque to write
+   */
+  template <typename Writer, typename Deque>
+  void WriteDeque(Writer &writer, Deque const &deq) {
+    using T = element_t<Deque>;
+    header_t header{magic, serializer_t<T>::format, deq.Size()};
+    writer.Write(&header, sizeof(header));
+    if constexpr (!serializer_t<T>::isBulk)
+      deq.ForEach([&writer](T const &data) {
+        serializer_t<T>::Write(writer, data);
+      });
+    else if constexpr (Writer::isBuffer)
+      deq.ForEachBlock([&writer](T const *data, size_t count) {
+        writer.Write(data, count * sizeof(T));
+      });
+    else {
+      unsigned char staging[stagingSize];
+      size_t used = 0;
+      deq.ForEachBlock([&writer, &staging, &used](T const *data, size_t count) {
+        size_t numOfBytes = count * sizeof(T);
+        if (used + numOfBytes > stagingSize) {
+          writer.Write(staging, used);
+          used = 0;
+        }
+        if (numOfBytes >= stagingSize)
+          writer.Write(data, numOfBytes);
+        else {
+          std::memcpy(staging + used, data, numOfBytes);
+          used += numOfBytes;
+        }
+      });
+      writer.Write(staging, used);
+    }
+  }
+
+  /**
+   * Read and check header function.
+   * @tparam T element type
+   * @tparam Reader reader type
+   * @param[in] reader reader to read from
+   * @return number of serialized elements
+   */
+  template <typename T, typename Reader>
+  std::uint64_t ReadHeader(Reader &reader) {
+    header_t header;
+    reader.Read(&header, sizeof(header));
+    if (header.mark != magic)
+      throw std::exception("Not a serialized deque");
+    if (header.format != serializer_t<T>::format)
+      throw std::exception("Serialized element type mismatch");
+    return header.count;
+  }
+
+  /**
+   * Read elements and push them back function.
+   * Raw byte elements are read with batches which are pushed as ranges.
+   * Elements pushed before exception stay in deque.
+   * @tparam Reader reader type
+   * @tparam Deque deque type
+   * @param[in] reader reader to read from
+   * @param[in, out] deq deque to push to
+   * @param[in, out] count number of elements, number of not pushed elements on exception
+   */
+  template <typename Reader, typename Deque>
+  void ReadElements(Reader &reader, Deque &deq, size_t &count) {
+    using T = element_t<Deque>;
+    if constexpr (serializer_t<T>::isBulk) {
+      static constexpr size_t batch = std::max<size_t>(1, stagingSize / sizeof(T));
+      alignas(T) unsigned char staging[batch * sizeof(T)];
+      while (count != 0) {
+        size_t read = std::min(count, batch);
+        reader.Read(staging, read * sizeof(T));
+        T const *elements = std::launder(reinterpret_cast<T const *>(staging));
+        deq.PushBack(elements, elements + read);
+        count -= read;
+      }
+    }
+    else
+      for (; count != 0; count--)
+        deq.EmplaceBack(serializer_t<T>::Read(reader));
+  }
+}
+
+/**
+ * Get number of bytes of serialized deque function.
+ * @tparam Deque deque type
+ * @param[in] deq deque to serialize
+ * @return number of bytes
+ */
+template <typename Deque>
+size_t SerializedSize(Deque const &deq) {
+  using T = serialization_detail::element_t<Deque>;
+  size_t numOfBytes = sizeof(serialization_detail::header_t);
+  if constexpr (serializer_t<T>::isBulk)
+    numOfBytes += deq.Size() * sizeof(T);
+  else
+    deq.ForEach([&numOfBytes](T const &data) {
+      numOfBytes += serializer_t<T>::Size(data);
+    });
+  return numOfBytes;
+}
+
+/**
+ * Write deque to binary stream function.
+ * Data has header with element count and native byte order, elements are written by 'serializer_t'.
+ * @tparam Deque deque type
+ * @param[in] stream binary stream to write to
+ * @param[in] deq deque to serialize
+ */
+template <typename Deque>
+void Serialize(std::ostream &stream, Deque const &deq) {
+  serialization_detail::stream_writer_t writer(stream);
+  serialization_detail::WriteDeque(writer, deq);
+}
+
+/**
+ * Write deque to raw buffer function. Buffer size may be found with 'SerializedSize'.
+ * @tparam Deque deque type
+ * @param[out] buffer buffer to write to
+ * @param[in] bufferSize number of buffer bytes
+ * @param[in] deq deque to serialize
+ * @return number of written bytes
+ */
+template <typename Deque>
+size_t Serialize(void *buffer, size_t bufferSize, Deque const &deq) {
+  serialization_detail::buffer_writer_t writer(buffer, bufferSize);
+  serialization_detail::WriteDeque(writer, deq);
+  return static_cast<size_t>(writer.Pos() - static_cast<unsigned char *>(buffer));
+}
+
+/**
+ * @brief Incremental deque deserializer class.
+ * @tparam T element type
+ *
+ * Reads header on construction and pushes elements to deque by parts,
+ * so large input is loaded without reading it whole first.
+ */
+template <typename T>
+class stream_deserializer_t {
+private:
+  serialization_detail::stream_reader_t reader;  ///< stream reader
+  std::uint64_t left;                            ///< number of elements left to read
+
+public:
+  /**
+   * Constructor. Reads and checks header.
+   * @param[in] stream binary stream to read from
+   */
+  explicit stream_deserializer_t(std::istream &stream) : reader(stream), left(0) {
+    left = serialization_detail::ReadHeader<T>(reader);
+  }
+
+  /**
+   * Get number of elements left to read function.
+   * @return number of elements
+   */
+  size_t Remaining(void) const {
+    return static_cast<size_t>(left);
+  }
+
+  /**
+   * Read elements and push them back function.
+   * Elements pushed before exception stay in deque.
+   * @tparam Deque deque type with elements of type T
+   * @param[in, out] deq deque to push to
+   * @param[in] maxCount maximal number of elements to read
+   * @return number of read elements
+   */
+  template <typename Deque>
+  size_t Load(Deque &deq, size_t maxCount = SIZE_MAX) {
+    static_assert(std::is_same<serialization_detail::element_t<Deque>, T>::value, "Deque element type mismatch");
+    size_t count = static_cast<size_t>(std::min<std::uint64_t>(left, maxCount)), unread = count;
+    try {
+      serialization_detail::ReadElements(reader, deq, unread);
+    }
+    catch (...) {
+      left -= count - unread;
+      throw;
+    }
+    left -= count;
+    return count;
+  }
+};
+
+/**
+ * Read deque from binary stream function.
+ * Elements are pushed back, elements pushed before exception stay in deque.
+ * @tparam Deque deque type
+ * @param[in] stream binary stream to read from
+ * @param[in, out] deq deque to push to
+ */
+template <typename Deque>
+void Deserialize(std::istream &stream, Deque &deq) {
+  stream_deserializer_t<serialization_detail::element_t<Deque>>(stream).Load(deq);
+}
+
+/**
+ * Read deque from raw buffer function.
+ * Elements are pushed back, elements pushed before exception stay in deque.
+ * @tparam Deque deque type
+ * @param[in] buffer buffer to read from
+ * @param[in] bufferSize number of buffer bytes
+ * @param[in, out] deq deque to push to
+ * @return number of read bytes
+ */
+template <typename Deque>
+size_t Deserialize(void const *buffer, size_t bufferSize, Deque &deq) {
+  serialization_detail::buffer_reader_t reader(buffer, bufferSize);
+  size_t count = static_cast<size_t>(serialization_detail::ReadHeader<serialization_detail::element_t<Deque>>(reader));
+  serialization_detail::ReadElements(reader, deq, count);
+  return static_cast<size_t>(reader.Pos() - static_cast<unsigned char const *>(buffer));
+}
+
+#endif /* __SERIALIZATION_H_INCLUDED */
@@ -0,0 +1,249 @@
+/**
+ * @file
+ * @brief Work-stealing deque header file
+ * @authors Vorotnikov Andrey
+ *
+ * Contains Chase-Lev work-stealing deque class
+ */
+
+#pragma once
+
+#ifndef __WORK_STEALING_DEQUE_H_INCLUDED
+#define __WORK_STEALING_DEQUE_H_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <type_traits>
+
+#include "../allocator/allocator.h"
+
+/**
+ * @brief Template work-stealing deque class.
+ * @tparam T deque elements type, trivially copyable (usually task pointer)
+ * @tparam Strategy allocation strategy type, 'alloc_strategy_t' means runtime strategy
+ *
+ * Chase-Lev deque on growing ring buffer.
+ * Owner thread calls PushBack/PopBack/TryPopBack which are wait-free except ring growth,
+ * any other thread steals from front with TrySteal/PopFront.
+ * Replaced rings are kept until destruction because thieves may still read them,
+ * strategy is called only by owner thread.
+ */
+template <typename T, typename Strategy = alloc_strategy_t>
+class work_stealing_deque_t {
+  static_assert(std::is_trivially_copyable<T>::value, "Work-stealing deque elements must be trivially copyable");
+
+private:
+  static constexpr size_t
+    cacheLine = 64,          ///< cache line size to separate owner and thieves data
+    defaultCapacity = 1024;  ///< default initial ring capacity
+
+  /**
+   * @brief Ring buffer struct.
+   *
+   * Ring of atomic slots with list link to previous replaced ring.
+   */
+  struct ring_t {
+    std::atomic<T> *slots;  ///< ring slots
+    int64_t mask;           ///< capacity minus one
+    ring_t *prev;           ///< previous replaced ring
+
+    /**
+     * Get slot by position function.
+     * @param[in] pos element position
+     * @return slot reference
+     */
+    std::atomic<T> &Slot(int64_t pos) {
+      return slots[pos & mask];
+    }
+  };
+
+  single_allocator_t<ring_t, Strategy> allocator;  ///< allocator for rings
+  alignas(cacheLine) std::atomic<int64_t> top;     ///< thieves end position
+  alignas(cacheLine) std::atomic<int64_t> bottom;  ///< owner end position
+  std::atomic<ring_t *> ring;                      ///< current ring
+
+  /**
+   * Allocate ring function.
+   * @param[in] capacity ring capacity, power of two
+   * @param[in] prev previous replaced ring
+   * @return allocated ring
+   */
+  ring_t *AllocRing(size_t capacity, ring_t *prev) {
+    ring_t *result = allocator.alloc();
+    try {
+      result->slots = single_allocator_t<std::atomic<T>, Strategy>(allocator).allocArray(capacity);
+    }
+    catch (...) {
+      allocator.dealloc(result);
+      throw;
+    }
+    result->mask = static_cast<int64_t>(capacity) - 1;
+    result->prev = prev;
+    return result;
+  }
+
+  /**
+   * Replace ring with bigger one function. Owner only.
+   * @param[in] old current ring
+   * @param[in] t thieves end position
+   * @param[in] b owner end position
+   * @return new ring
+   */
+  ring_t *Grow(ring_t *old, int64_t t, int64_t b) {
+    ring_t *result = AllocRing(static_cast<size_t>(old->mask + 1) * 2, old);
+    for (int64_t i = t; i < b; i++)
+      result->Slot(i).store(old->Slot(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+    ring.store(result, std::memory_order_release);
+    return result;
+  }
+
+  /**
+   * Initialize empty deque function.
+   * @param[in] capacity initial capacity
+   */
+  void Init(size_t capacity) {
+    size_t roundedCapacity = 2;
+    while (roundedCapacity < capacity)
+      roundedCapacity *= 2;
+    top.store(0, std::memory_order_relaxed);
+    bottom.store(0, std::memory_order_relaxed);
+    ring.store(AllocRing(roundedCapacity, nullptr), std::memory_order_relaxed);
+  }
+
+public:
+  /**
+   * Constructor with capacity. Available only for static strategy.
+   * @param[in] capacity initial capacity, rounded up to power of two
+   */
+  explicit work_stealing_deque_t(size_t capacity = defaultCapacity) {
+    Init(capacity);
+  }
+
+  /**
+   * Constructor with strategy function.
+   * @param[in] strategy allocation strategy
+   * @param[in] capacity initial capacity, rounded up to power of two
+   */
+  work_stealing_deque_t(std::shared_ptr<alloc_strategy_t> const &strategy, size_t capacity = defaultCapacity) :
+    allocator(strategy) {
+    Init(capacity);
+  }
+
+  /**
+   * Deleted copy constructor.
+   */
+  work_stealing_deque_t(work_stealing_deque_t const &) = delete;
+
+  /**
+   * Deleted copy operator =.
+   */
+  work_stealing_deque_t &operator=(work_stealing_deque_t const &) = delete;
+
+  /**
+   * Destructor.
+   */
+  ~work_stealing_deque_t(void) {
+    for (ring_t *r = ring.load(std::memory_order_relaxed); r != nullptr; ) {
+      ring_t *prev = r->prev;
+      single_allocator_t<std::atomic<T>, Strategy>(allocator).deallocArray(r->slots, static_cast<size_t>(r->mask + 1));
+      allocator.dealloc(r);
+      r = prev;
+    }
+  }
+
+  /**
+   * Push element back function. Owner only.
+   * @param[in] data data to push
+   */
+  void PushBack(T const &data) {
+    int64_t
+      b = bottom.load(std::memory_order_relaxed),
+      t = top.load(std::memory_order_acquire);
+    ring_t *r = ring.load(std::memory_order_relaxed);
+    if (b - t > r->mask)
+      r = Grow(r, t, b);
+    r->Slot(b).store(data, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Try to pop element back function. Owner only.
+   * @param[out] data poped element
+   * @return true if element was poped, false if deque is empty
+   */
+  bool TryPopBack(T &data) {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    ring_t *r = ring.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    data = r->Slot(b).load(std::memory_order_relaxed);
+    if (t == b) {
+      // last element: race with thieves
+      bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  /**
+   * Pop element back function. Owner only.
+   * @return poped element
+   */
+  T PopBack(void) {
+    T data;
+    if (!TryPopBack(data))
+      throw std::exception("Empty list");
+    return data;
+  }
+
+  /**
+   * Try to steal element front function. Any thread.
+   * Single attempt: fails if deque is empty or another thread has taken the element.
+   * @param[out] data stolen element
+   * @return true if element was stolen, false - otherwise
+   */
+  bool TrySteal(T &data) {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b)
+      return false;
+    ring_t *r = ring.load(std::memory_order_acquire);
+    T stolen = r->Slot(t).load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      return false;
+    data = stolen;
+    return true;
+  }
+
+  /**
+   * Pop element front function. Any thread.
+   * Retries steal while deque is not empty.
+   * @return poped element
+   */
+  T PopFront(void) {
+    T data;
+    while (!TrySteal(data))
+      if (IsEmpty())
+        throw std::exception("Empty list");
+    return data;
+  }
+
+  /**
+   * Is empty check function. Result may be outdated when it is returned.
+   * @return true if deque is empty, false - otherwise
+   */
+  bool IsEmpty(void) const {
+    return top.load(std::memory_order_acquire) >= bottom.load(std::memory_order_acquire);
+  }
+};
+
+#endif /* __WORK_STEALING_DEQUE_H_INCLUDED */
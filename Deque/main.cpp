@@ -13,9 +13,70 @@
  * Deque with custom allocators project.
  */
 
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <thread>
+
 #include "deque/deque.h"
+#include "deque/chunked_deque.h"
+#include "deque/ring_deque.h"
+#include "deque/concurrent_deque.h"
+#include "deque/parallel.h"
+#include "deque/serialization.h"
+#include "deque/persistent_deque.h"
 #include "allocator/stupid_strategy.h"
+#include "allocator/pool_strategy.h"
+#include "allocator/arena_strategy.h"
+#include "allocator/synchronized_strategy.h"
 #include "allocator/allocator.h"
+#include "allocator/std_adapters.h"
+
+#ifdef __cpp_impl_coroutine
+/**
+ * @brief Eagerly started detached coroutine struct.
+ */
+struct demo_task_t {
+  /**
+   * @brief Coroutine promise struct.
+   */
+  struct promise_type {
+    demo_task_t get_return_object(void) {
+      return {};
+    }
+    std::suspend_never initial_suspend(void) {
+      return {};
+    }
+    std::suspend_never final_suspend(void) noexcept {
+      return {};
+    }
+    void return_void(void) {
+    }
+    void unhandled_exception(void) {
+      std::terminate();
+    }
+  };
+};
+
+/**
+ * Push three elements coroutine.
+ * @param[in] channel deque to push to
+ */
+demo_task_t ProduceThree(concurrent_deque_t<int, concurrency_mode_t::MPMC> &channel) {
+  for (int i = 1; i <= 3; i++)
+    co_await channel.AsyncPushBack(i);
+}
+
+/**
+ * Pop two elements coroutine.
+ * @param[in] channel deque to pop from
+ * @param[out] sum sum of poped elements
+ */
+demo_task_t ConsumeTwo(concurrent_deque_t<int, concurrency_mode_t::MPMC> &channel, int &sum) {
+  sum += co_await channel.AsyncPopFront();
+  sum += co_await channel.AsyncPopFront();
+}
+#endif
 
 /**
  * Main program function.
@@ -81,5 +142,142 @@ int main(void) {
   // is empty demo
   std::cout << "15) " << std::boolalpha << deq3.IsEmpty() << ", " << deq1.IsEmpty() << std::endl;
 
+  // chunked deque demo
+  chunked_deque_t<int, alloc_strategy_t, 4> chunkedDeq(std::make_shared<stupid_strategy_t>());
+  for (int i = 0; i < 5; i++) {
+    chunkedDeq.PushBack(i + 5);
+    chunkedDeq.PushFront(4 - i);
+  }
+  std::cout << "16) " << chunkedDeq << std::endl;
+  chunkedDeq.ChangeAllocator(std::make_shared<pool_strategy_t>());
+  std::cout << "17) " << chunkedDeq.PopFront() << " " << chunkedDeq.PopBack() << std::endl;
+  for (auto &i : chunkedDeq)
+    i *= 10;
+  std::cout << "18) " << chunkedDeq << std::endl;
+
+  // static strategy demo, static strategy must be thread safe
+  deque_t<int, synchronized_strategy_t<pool_strategy_t>> staticDeq;
+  staticDeq.PushBack(2);
+  staticDeq.PushFront(1);
+  std::cout << "19) " << staticDeq << std::endl;
+
+  // arena strategy demo
+  deque_t<int> arenaDeq(std::make_shared<arena_strategy_t>());
+  arenaDeq.PushBack({1, 2, 3});
+  std::cout << "20) " << arenaDeq << std::endl;
+  arenaDeq.Clear();
+
+  // random access iterators demo
+  chunked_deque_t<int> sortedDeq(std::make_shared<pool_strategy_t>());
+  sortedDeq.PushBack({5, 3, 9, 1, 7});
+  std::sort(sortedDeq.begin(), sortedDeq.end());
+  std::cout << "21) " << sortedDeq << std::lower_bound(sortedDeq.cbegin(), sortedDeq.cend(), 6) - sortedDeq.cbegin() << " " << sortedDeq.At(4) << std::endl;
+
+  // parallel algorithms demo
+  ParallelTransform(sortedDeq, [](int i) {
+    return i * 2;
+  });
+  std::cout << "22) " << ParallelReduce(sortedDeq, 0, [](int a, int b) {
+    return a + b;
+  }) << " " << *ParallelFindIf(sortedDeq, [](int i) {
+    return i > 10;
+  }) << std::endl;
+
+  // snapshot demo
+  auto snapshot = sortedDeq.Snapshot();
+  sortedDeq.PushBack(20);
+  sortedDeq[0] = 0;
+  std::cout << "23) " << *snapshot << "/ " << sortedDeq << std::endl;
+
+  // standard library adapters demo
+  std::pmr::monotonic_buffer_resource buffer;
+  deque_t<int> pmrDeq(std::make_shared<memory_resource_strategy_t>(&buffer));
+  std::pmr::vector<int> pmrVector(&buffer);
+  pmrDeq.PushBack({1, 2, 3});
+  pmrVector.assign(pmrDeq.begin(), pmrDeq.end());
+  auto sharedPool = std::make_shared<pool_strategy_t>();
+  strategy_resource_t poolResource(sharedPool);
+  std::pmr::vector<int> poolVector(pmrVector.begin(), pmrVector.end(), &poolResource);
+  std::vector<int, std_allocator_t<int>> stdVector(poolVector.begin(), poolVector.end(), std_allocator_t<int>(sharedPool));
+  std::cout << "24) " << pmrDeq << pmrVector.size() << " " << poolVector.back() << " " << stdVector.front() << std::endl;
+
+  // inline storage demo
+  small_deque_t<int, 4> smallDeq(sharedPool);
+  smallDeq.PushBack({1, 2, 3});
+  smallDeq.PushFront(0);
+  std::cout << "25) " << smallDeq << smallDeq.Capacity() << std::endl;
+
+  // ring deque demo
+  ring_deque_t<int, 4, overflow_policy_t::Overwrite> ringDeq(sharedPool);
+  ringDeq.PushBack({1, 2, 3, 4});
+  ringDeq.PushBack(5);
+  ringDeq.PushFront(0);
+  std::cout << "26) " << ringDeq << ringDeq.Size() << std::endl;
+
+  // splice and split demo
+  deque_t<int> headDeq(sharedPool), restDeq(sharedPool);
+  headDeq.PushBack({1, 2});
+  restDeq.PushBack({3, 4, 5});
+  headDeq.Append(std::move(restDeq));
+  restDeq = headDeq.SplitAt(std::next(headDeq.begin(), 3));
+  std::cout << "27) " << headDeq << restDeq << restDeq.Size() << std::endl;
+
+  // serialization demo
+  std::stringstream checkpoint;
+  Serialize(checkpoint, headDeq);
+  chunked_deque_t<int> loadedDeq(sharedPool);
+  Deserialize(checkpoint, loadedDeq);
+  deque_t<std::string> textDeq(sharedPool);
+  textDeq.PushBack({"ab", "c"});
+  std::vector<unsigned char> textBuffer(SerializedSize(textDeq));
+  Serialize(textBuffer.data(), textBuffer.size(), textDeq);
+  deque_t<std::string> loadedText(sharedPool);
+  Deserialize(textBuffer.data(), textBuffer.size(), loadedText);
+  std::cout << "28) " << loadedDeq << loadedText << textBuffer.size() << std::endl;
+
+  // persistent deque demo
+  {
+    persistent_deque_t<int> storedDeq(std::make_shared<mapped_file_strategy_t>("deque.bin", 1024 * 1024));
+    storedDeq.PushBack({1, 2, 3});
+  }
+  {
+    persistent_deque_t<int> reopenedDeq(std::make_shared<mapped_file_strategy_t>("deque.bin", 1024 * 1024));
+    reopenedDeq.PushFront(0);
+    std::cout << "29) " << reopenedDeq << reopenedDeq.Size() << std::endl;
+  }
+  std::remove("deque.bin");
+
+  // waiting consumer demo
+  concurrent_deque_t<int, concurrency_mode_t::MPMC> sharedQueue(8, sharedPool);
+  std::thread producer([&sharedQueue] {
+    sharedQueue.PushBack(1);
+    sharedQueue.PushBack(2);
+  });
+  int firstItem = sharedQueue.WaitPopFront();
+  std::optional<int> secondItem = sharedQueue.WaitPopFront(std::chrono::seconds(1));
+  producer.join();
+  std::cout << "30) " << firstItem << ", " << *secondItem << ", " << sharedQueue.WaitPopFront(std::chrono::milliseconds(1)).has_value() << std::endl;
+
+#ifdef __cpp_impl_coroutine
+  // coroutine channel demo: producer suspends on full deque, consumer resumes it
+  concurrent_deque_t<int, concurrency_mode_t::MPMC> channel(2, sharedPool);
+  int channelSum = 0;
+  ProduceThree(channel);
+  ConsumeTwo(channel, channelSum);
+  std::cout << "31) " << channelSum << ", " << channel.PopFront() << std::endl;
+#endif
+
+  // node cache demo: steady-state queue reuses freed nodes
+  deque_t<int> fifoDeq(sharedPool);
+  for (int round = 0; round < 100; round++) {
+    fifoDeq.PushBack({round, round + 1, round + 2});
+    fifoDeq.PopFront();
+    fifoDeq.PopFront();
+    fifoDeq.PopFront();
+  }
+  size_t cachedCapacity = fifoDeq.Capacity();
+  fifoDeq.Trim();
+  std::cout << "32) " << cachedCapacity << ", " << fifoDeq.Capacity() << std::endl;
+
   return 0;
 }